@@ -0,0 +1,349 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Standard libraries
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//Yosys library
+#include "backends/ilang/ilang_backend.h"
+#include "libs/sha1/sha1.h"
+
+//Application libraries
+#include "analysis_cache.h"
+
+namespace
+{
+    /*
+     *  Strings are written as <length>:<bytes>, names may hold any character.
+     */
+    void writeString(std::ostream &out, const std::string &text)
+    {
+        out << text.size() << ':' << text;
+    }
+
+    bool readString(std::istream &in, std::string &text)
+    {
+        size_t length = 0;
+        char separator = 0;
+
+        if(!(in >> length) || !in.get(separator) || separator != ':')
+        {
+            return false;
+        }
+
+        text.resize(length);
+
+        return length == 0 || (bool)in.read(&text[0], length);
+    }
+
+    //Header line of every entry
+    std::string entryHeader()
+    {
+        return "SANS-CACHE " + std::to_string(AnalysisCache::AnalysisCache::CACHE_VERSION);
+    }
+
+    /*
+     *  ilang dump of the module without its attribute lines.
+     */
+    std::string canonicalDump(RTLIL::Module *module, RTLIL::Design *design)
+    {
+        std::stringstream dump;
+        std::string canonical;
+        std::string line;
+
+        ILANG_BACKEND::dump_module(dump, "", module, design, false);
+
+        while(std::getline(dump, line))
+        {
+            size_t first = line.find_first_not_of(" \t");
+
+            if(first != std::string::npos && line.compare(first, 10, "attribute ") == 0)
+            {
+                continue;
+            }
+
+            canonical += line;
+            canonical += '\n';
+        }
+
+        return canonical;
+    }
+
+    /*
+     *  Hash of a module and, first, of the modules it instantiates. state: 1 while the module is being hashed, 2 once done.
+     */
+    const std::string &hashModule(RTLIL::Module *module, RTLIL::Design *design, const std::map<std::string, RTLIL::Module *> &designModules,
+                                  std::map<RTLIL::Module *, int> &state, std::map<RTLIL::Module *, std::string> &hashes)
+    {
+        state[module] = 1;
+
+        //Same naming used by mod2graph for the node types
+        std::set<std::string> children;
+        for(auto cell : module->cells())
+        {
+            std::string type = cell->type.str();
+
+            if(type.substr(0, 2) == "\\$")
+            {
+                type = type.substr(1);
+            }
+
+            if(designModules.count(type) > 0)
+            {
+                children.insert(type);
+            }
+        }
+
+        SHA1 sha;
+        sha.update(entryHeader() + "\n");
+        sha.update(canonicalDump(module, design));
+
+        for(auto &child : children)
+        {
+            RTLIL::Module *childModule = designModules.at(child);
+            std::string childHash = "cycle";
+
+            if(state[childModule] == 0)
+            {
+                childHash = hashModule(childModule, design, designModules, state, hashes);
+            }
+            else if(state[childModule] == 2)
+            {
+                childHash = hashes[childModule];
+            }
+
+            sha.update("child " + child + " " + childHash + "\n");
+        }
+
+        state[module] = 2;
+        hashes[module] = sha.final();
+
+        return hashes[module];
+    }
+}
+
+AnalysisCache::AnalysisCache::AnalysisCache(std::string directory) : directory(std::move(directory))
+{
+    mkdir(this->directory.c_str(), 0777);
+}
+
+const std::string &AnalysisCache::AnalysisCache::getDirectory() const { return this->directory; }
+
+std::string AnalysisCache::AnalysisCache::entryPath(const std::string &hash) const
+{
+    return this->directory + "/" + hash + ".sans";
+}
+
+std::vector<std::string> AnalysisCache::AnalysisCache::hashModules(RTLIL::Design *design, const std::vector<RTLIL::Module *> &modules)
+{
+    std::map<std::string, RTLIL::Module *> designModules;
+    std::map<RTLIL::Module *, int> state;
+    std::map<RTLIL::Module *, std::string> hashes;
+    std::vector<std::string> result;
+
+    for(auto mod : design->modules())
+    {
+        designModules[mod->name.str()] = mod;
+    }
+
+    for(auto module : modules)
+    {
+        if(state[module] == 0)
+        {
+            hashModule(module, design, designModules, state, hashes);
+        }
+
+        result.push_back(hashes[module]);
+    }
+
+    return result;
+}
+
+std::string AnalysisCache::AnalysisCache::hashContent(RTLIL::Module *module)
+{
+    SHA1 sha;
+    sha.update(canonicalDump(module, module->design));
+
+    return sha.final();
+}
+
+std::unique_ptr<AnalysisCache::CachedModule> AnalysisCache::AnalysisCache::load(const std::string &hash) const
+{
+    std::ifstream in(this->entryPath(hash), std::ios::binary);
+    std::unique_ptr<CachedModule> entry(new CachedModule());
+    std::string header;
+    std::string tag;
+    size_t count = 0;
+
+    if(!in || !std::getline(in, header) || header != entryHeader())
+    {
+        return nullptr;
+    }
+
+    if(!(in >> tag) || tag != "module" || !readString(in, entry->moduleName))
+    {
+        return nullptr;
+    }
+
+    if(!(in >> tag >> count) || tag != "inner")
+    {
+        return nullptr;
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        std::string inner;
+
+        if(!readString(in, inner))
+        {
+            return nullptr;
+        }
+
+        entry->innerModules.push_back(inner);
+    }
+
+    if(!(in >> tag >> count) || tag != "results")
+    {
+        return nullptr;
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        std::string name;
+        int msb = 0, lsb = 0, data = 0, select = 0;
+
+        if(!readString(in, name) || !(in >> msb >> lsb >> data >> select))
+        {
+            return nullptr;
+        }
+
+        entry->results.push_back(std::make_pair(Signal::Signal(name, msb, lsb), std::make_pair(data != 0, select != 0)));
+    }
+
+    if(!(in >> tag >> count) || tag != "slices")
+    {
+        return nullptr;
+    }
+
+    for(size_t i = 0; i < count; i++)
+    {
+        std::string name;
+        std::string letters;
+        int msb = 0, lsb = 0;
+
+        if(!readString(in, name) || !(in >> msb >> lsb) || !readString(in, letters))
+        {
+            return nullptr;
+        }
+
+        //Letters are stored as they are printed, MSB first
+        int width = (int)letters.size();
+        SlicePlanes::SlicePlanes planes(width);
+
+        for(int k = 0; k < width; k++)
+        {
+            char letter = letters[k];
+
+            if(letter != 'N' && letter != 'D' && letter != 'S' && letter != 'B')
+            {
+                return nullptr;
+            }
+
+            planes.mark(width - 1 - k, width - 1 - k, std::make_pair(letter == 'D' || letter == 'B', letter == 'S' || letter == 'B'));
+        }
+
+        entry->sliceStructure.push_back(std::make_pair(Signal::Signal(name, msb, lsb), planes));
+    }
+
+    //A truncated file never reaches the trailer
+    if(!(in >> tag) || tag != "end")
+    {
+        return nullptr;
+    }
+
+    return entry;
+}
+
+bool AnalysisCache::AnalysisCache::store(const std::string &hash, const CachedModule &entry) const
+{
+    std::string path = this->entryPath(hash);
+    std::string temporary = path + "." + std::to_string(getpid()) + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+
+        if(!out)
+        {
+            return false;
+        }
+
+        out << entryHeader() << "\n";
+
+        out << "module ";
+        writeString(out, entry.moduleName);
+        out << "\n";
+
+        out << "inner " << entry.innerModules.size() << "\n";
+        for(auto &inner : entry.innerModules)
+        {
+            writeString(out, inner);
+            out << "\n";
+        }
+
+        out << "results " << entry.results.size() << "\n";
+        for(auto &result : entry.results)
+        {
+            writeString(out, result.first.getSignalName());
+            out << " " << result.first.getMSB() << " " << result.first.getLSB() << " " << result.second.first << " " << result.second.second << "\n";
+        }
+
+        out << "slices " << entry.sliceStructure.size() << "\n";
+        for(auto &slice : entry.sliceStructure)
+        {
+            writeString(out, slice.first.getSignalName());
+            out << " " << slice.first.getMSB() << " " << slice.first.getLSB() << " ";
+            writeString(out, slice.second.toString());
+            out << "\n";
+        }
+
+        out << "end\n";
+
+        if(!out.flush())
+        {
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+
+    if(std::rename(temporary.c_str(), path.c_str()) != 0)
+    {
+        std::remove(temporary.c_str());
+        return false;
+    }
+
+    return true;
+}
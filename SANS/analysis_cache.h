@@ -0,0 +1,102 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef ANALYSIS_CACHE_H
+#define ANALYSIS_CACHE_H
+
+//Standard libraries
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Yosys library
+#include "kernel/yosys.h"
+
+//Application libraries
+#include "signal_library.h"
+#include "slice_planes.h"
+
+USING_YOSYS_NAMESPACE
+
+namespace AnalysisCache
+{
+    /*
+     *  Everything the report and the parent modules need from the analysis of a module, so that an unchanged module needs neither its
+     *  Generator nor its DFS.
+     */
+    struct CachedModule
+    {
+        std::string moduleName;
+        //Types of the module placeholders met inside the module (see Generator::getInnerModules)
+        std::vector<std::string> innerModules;
+        //DFS_FTSA results, in their order
+        std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > results;
+        //Slice structure left on the Generator by DFS_FTSA
+        SlicePlanes::SliceStructure sliceStructure;
+    };
+
+    /*
+     *  On-disk cache of the analysis results, one file per module in a directory. Entries are keyed by a content hash: the SHA-1 of the
+     *  ilang dump of the module (attributes left out, they do not take part in the analysis) followed by the hashes of the modules it
+     *  instantiates. An edited module changes its own key and the keys of all its ancestors, everything else is found again.
+     *  CACHE_VERSION is part of the key: bump it whenever the analysis changes its results.
+     */
+    class AnalysisCache
+    {
+        private:
+            std::string directory;
+
+            std::string entryPath(const std::string &hash) const;
+
+        public:
+            static const int CACHE_VERSION = 2;
+
+            /*
+             *  The directory is created if it does not exist yet.
+             */
+            AnalysisCache(std::string directory);
+
+            const std::string &getDirectory() const;
+
+            /*
+             *  Content hash of each module, in the same order. Reads the design: call it while holding the kernel.
+             *  Modules that are part of an instantiation cycle get a hash too, but they are never analyzed.
+             */
+            static std::vector<std::string> hashModules(RTLIL::Design *design, const std::vector<RTLIL::Module *> &modules);
+
+            /*
+             *  SHA-1 of the canonical dump of the module alone, without the modules it instantiates. Reads the design: hold the kernel.
+             */
+            static std::string hashContent(RTLIL::Module *module);
+
+            /*
+             *  Entry stored under the hash, nullptr if there is none or if it cannot be read back.
+             */
+            std::unique_ptr<CachedModule> load(const std::string &hash) const;
+
+            /*
+             *  Writes the entry under the hash. The file is written aside and renamed, so concurrent runs never read half an entry.
+             *  Returns false if the entry could not be written. Safe to call from different threads for different hashes.
+             */
+            bool store(const std::string &hash, const CachedModule &entry) const;
+    };
+}
+
+#endif
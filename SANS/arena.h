@@ -0,0 +1,105 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef ARENA_H
+#define ARENA_H
+
+//Standard libraries
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Arena
+{
+	/*
+	 *	Typed arena: objects of type T are built in place inside fixed-size blocks, so they never move once created and sit next to each other in
+	 *	memory. Objects are addressed by their creation index. Nothing is freed one by one: release() (or the destructor) destroys all of them at once.
+	 */
+	template<typename T, std::size_t BLOCK_SIZE = 256>
+	class Arena
+	{
+		private:
+			//Raw storage, each block holds BLOCK_SIZE objects
+			std::vector< std::unique_ptr<typename std::aligned_storage<sizeof(T), alignof(T)>::type[]> > blocks;
+			//Number of objects built so far
+			std::size_t count = 0;
+
+			T *slot(std::size_t index) const
+			{
+				return reinterpret_cast<T *>(&this->blocks[index / BLOCK_SIZE][index % BLOCK_SIZE]);
+			}
+
+		public:
+			Arena() {}
+
+			//Objects are handed out as raw pointers, copying the arena would leave them dangling
+			Arena(const Arena &) = delete;
+			Arena &operator=(const Arena &) = delete;
+
+			~Arena() { this->release(); }
+
+			/*
+			 *	Builds a new object with the given constructor arguments and returns its (stable) address.
+			 */
+			template<typename... Args>
+			T *create(Args&&... args)
+			{
+				if( this->count == this->blocks.size() * BLOCK_SIZE )
+				{
+					this->blocks.emplace_back(new typename std::aligned_storage<sizeof(T), alignof(T)>::type[BLOCK_SIZE]);
+				}
+
+				T *object = new (this->slot(this->count)) T(std::forward<Args>(args)...);
+				this->count++;
+
+				return object;
+			}
+
+			/*
+			 *	Object built by the index-th call to create().
+			 */
+			T *at(std::size_t index) const { return this->slot(index); }
+
+			std::size_t size() const { return this->count; }
+
+			/*
+			 *	Bytes reserved by the arena, useful for keeping track of the memory taken by an analysis.
+			 */
+			std::size_t capacityBytes() const { return this->blocks.size() * BLOCK_SIZE * sizeof(T); }
+
+			/*
+			 *	Destroys every object (in reverse creation order) and gives the blocks back.
+			 */
+			void release()
+			{
+				while( this->count > 0 )
+				{
+					this->count--;
+					this->slot(this->count)->~T();
+				}
+
+				this->blocks.clear();
+			}
+	};
+}
+
+#endif
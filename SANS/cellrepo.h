@@ -55,6 +55,17 @@ namespace CellRepository
         DEDICATED_OPERATOR = 9,
     };
 
+    /*
+     * Bitmask of the roles a port plays in a cell, precomputed for every <cell type, port> of the repository
+     */
+    enum PortRole
+    {
+        NO_PORT_ROLE = 0,
+        DATA_INPUT_ROLE = 1,
+        SELECTION_INPUT_ROLE = 2,
+        OUTPUT_ROLE = 4,
+    };
+
     /*
      * Structure that represent an element(i.e. node) of the circuit exploiting its components(i.e. ports) by functionalities.
      */
@@ -183,6 +194,10 @@ namespace CellRepository
             std::string toString();
     };
 
+    /*
+     * Read-only repository of the cells provided by Yosys, shared by the whole process through getInstance().
+     * Cells and port roles are indexed by IdString, so that a lookup is a single hash probe instead of a scan of the repository.
+     */
     class CellRepository
     {
         private:
@@ -195,6 +210,17 @@ namespace CellRepository
              * Empty vector used when a specifici cell doesn't have certain ports (like data inputs or selection inputs)
              */
             std::vector<std::string> void_vector;
+            /*
+             * Indexes keyed by the index of the interned names. interned_names holds a reference to each of them, so the indexes stay valid,
+             * and lookups never copy an IdString (which would update the global reference counters).
+             */
+            std::vector<Yosys::RTLIL::IdString> interned_names;
+            //Index of each interned name, looked up by string without touching the global IdString tables
+            Yosys::dict<std::string, int> name_ids;
+            //Cells indexed by type
+            Yosys::dict<int, CellStructure *> cells_index;
+            //PortRole bitmask of every <cell type, port name>
+            Yosys::dict<std::pair<int, int>, int> port_roles;
 
             /*
              *  Method used to define and store some standard unary operator cell structures
@@ -216,19 +242,52 @@ namespace CellRepository
              */
             void buildCellRepository();
 
-        public:
+            /*
+             * Method used to fill cells_index and port_roles once the repository has been built
+             */
+            void buildIndex();
+
+            /*
+             * Returns the index of name if the repository knows it, -1 otherwise. Only name_ids is read: the global IdString tables may be
+             * growing in another thread.
+             */
+            int findId(const std::string &name) const;
+
+            //Interns name for the lifetime of the repository and returns its index
+            int intern(const std::string &name);
+
             CellRepository();
+
+        public:
             //Method used for retriving the singleton instance of CellRepository
             static CellRepository *getInstance() ;
 
-            std::vector<CellStructure *> getCellRepository(){ return this->cells_repository; }
+            const std::vector<CellStructure *> &getCellRepository() const { return this->cells_repository; }
 
             /*
              * Method that return a specific cell based on its cellType :
              * return nullptr -> No cell found with such name
              * return ! nullptr -> Cell requested
              */
-            CellStructure *getCell(std::string cellType);
+            CellStructure *getCell(std::string cellType) const;
+            CellStructure *getCell(const Yosys::RTLIL::IdString &cellType) const;
+
+            /*
+             * Method that returns the PortRole bitmask of port in cells of type cellType (NO_PORT_ROLE for unknown cells or ports)
+             */
+            int getPortRole(const Yosys::RTLIL::IdString &cellType, const Yosys::RTLIL::IdString &port) const;
+            int getPortRole(const std::string &cellType, const std::string &port) const;
+
+            /*
+             * Method used to check if port is a selection input of cells of type cellType
+             */
+            bool isSelectionPort(const std::string &cellType, const std::string &port) const;
+
+            /*
+             * Hashlib tables rehash lazily inside lookups, so even const lookups write until the table has settled. This method settles the
+             * repository indexes: afterwards the lookups above are read-only and can run from several threads.
+             */
+            static void prepareConcurrentLookups();
 
             virtual ~CellRepository()
             {
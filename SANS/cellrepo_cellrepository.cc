@@ -165,22 +165,102 @@ void CellRepository::CellRepository::buildCellRepository()
 CellRepository::CellRepository::CellRepository()
 {
 	this->buildCellRepository();
+	this->buildIndex();
 }
 
+CellRepository::CellRepository* CellRepository::CellRepository::getInstance()
+{
+	//Built once, on first use, and never modified afterwards
+	static CellRepository instance;
 
+	return &instance;
+}
 
-CellRepository::CellStructure* CellRepository::CellRepository::getCell(std::string cellType)
+void CellRepository::CellRepository::buildIndex()
 {
-    CellStructure* res = nullptr;
-    
-    for(auto cs : this->getCellRepository())
+    for(auto cs : this->cells_repository)
     {
-        if(cs->getType().compare(cellType) == 0)
+        int type = this->intern(cs->getType());
+
+        //The first definition wins, as with the former linear scan
+        if(this->cells_index.count(type) > 0)
+        {
+            continue;
+        }
+
+        this->cells_index[type] = cs;
+
+        for(auto p : cs->getDataInputs())
+        {
+            this->port_roles[std::make_pair(type, this->intern(p))] |= DATA_INPUT_ROLE;
+        }
+
+        for(auto p : cs->getSelectionInputs())
         {
-            res = cs;
-            break;
+            this->port_roles[std::make_pair(type, this->intern(p))] |= SELECTION_INPUT_ROLE;
+        }
+
+        for(auto p : cs->getOutputs())
+        {
+            this->port_roles[std::make_pair(type, this->intern(p))] |= OUTPUT_ROLE;
         }
     }
+}
+
+int CellRepository::CellRepository::intern(const std::string &name)
+{
+    this->interned_names.push_back(Yosys::RTLIL::IdString(name));
+    this->name_ids[name] = this->interned_names.back().index_;
+
+    return this->interned_names.back().index_;
+}
+
+int CellRepository::CellRepository::findId(const std::string &name) const
+{
+    auto it = this->name_ids.find(name);
+
+    return it == this->name_ids.end() ? -1 : it->second;
+}
+
+CellRepository::CellStructure* CellRepository::CellRepository::getCell(std::string cellType) const
+{
+    auto it = this->cells_index.find(findId(cellType));
+
+    return it == this->cells_index.end() ? nullptr : it->second;
+}
+
+CellRepository::CellStructure* CellRepository::CellRepository::getCell(const Yosys::RTLIL::IdString &cellType) const
+{
+    auto it = this->cells_index.find(cellType.index_);
+
+    return it == this->cells_index.end() ? nullptr : it->second;
+}
+
+int CellRepository::CellRepository::getPortRole(const Yosys::RTLIL::IdString &cellType, const Yosys::RTLIL::IdString &port) const
+{
+    auto it = this->port_roles.find(std::make_pair(cellType.index_, port.index_));
 
-    return res;
+    return it == this->port_roles.end() ? NO_PORT_ROLE : it->second;
+}
+
+int CellRepository::CellRepository::getPortRole(const std::string &cellType, const std::string &port) const
+{
+    auto it = this->port_roles.find(std::make_pair(findId(cellType), findId(port)));
+
+    return it == this->port_roles.end() ? NO_PORT_ROLE : it->second;
+}
+
+void CellRepository::CellRepository::prepareConcurrentLookups()
+{
+    CellRepository *instance = getInstance();
+
+    //A lookup of any key performs the pending rehash
+    instance->name_ids.count(std::string());
+    instance->cells_index.count(-1);
+    instance->port_roles.count(std::make_pair(-1, -1));
+}
+
+bool CellRepository::CellRepository::isSelectionPort(const std::string &cellType, const std::string &port) const
+{
+    return (this->getPortRole(cellType, port) & SELECTION_INPUT_ROLE) != 0;
 }
@@ -19,17 +19,17 @@
 
 #include "design_analyzer.h"
 
-void DesignAnalyzer::DesignAnalyzer::wrapModule(RTLIL::Module *module)
+Generator::Generator *DesignAnalyzer::DesignAnalyzer::wrapModule(RTLIL::Module *module, bool deferLog)
 {
     SubCircuit_v2::Graph internalState;
     Generator::Generator *gen = nullptr ;
     
-    gen = new Generator::Generator(internalState, module);
+    gen = new Generator::Generator(internalState, module, false, deferLog);
     
     //GeneratorAnalyzer::GeneratorAnalyzer undyne;
     //undyne.PRINT_supportGraph(gen);
 
-    this->wrappedModules.push_back(gen);
+    return gen;
 }
 
 std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > DesignAnalyzer::DesignAnalyzer::sort( std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > toSort)
@@ -59,195 +59,163 @@ std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > DesignAnalyzer
     return sorted;
 }
 
-std::vector<std::string> DesignAnalyzer::DesignAnalyzer::prepareResults( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense )
+DesignAnalyzer::DesignAnalyzer::DesignAnalyzer(RTLIL::Design *design, int threads, std::string cacheDirectory, Incremental::ResidentState *resident,
+                                               Profiler::Profiler *profiler)
 {
-    std::vector<std::string> res;
+    this->resident = resident;
 
-    res.push_back(preparePlaintext(title, mod, allResults, condense));
-    res.push_back(prepareXML(title, mod, allResults, condense));
-    res.push_back(prepareJSON(title, mod, allResults, condense));
-    res.push_back(prepareCSV(title, mod, allResults, condense));
+    for(auto module : design->modules())
+    {
+        this->designModules.push_back(module);
+        this->moduleNames.push_back(module->name.str());
+        this->profiles.push_back(profiler != nullptr ? profiler->module(module->name.str()) : nullptr);
+    }
 
-    return res;
-}
+    int moduleCount = (int)this->designModules.size();
+    this->wrappedModules.assign(moduleCount, nullptr);
+    this->innerModules.resize(moduleCount);
+    this->cachedModules.resize(moduleCount);
+    this->reusedModules.assign(moduleCount, 0);
 
-std::string DesignAnalyzer::DesignAnalyzer::preparePlaintext( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense )
-{
-    std::stringstream plaintext;
-    //Not condensing
-    if(!condense)
-    {
-        plaintext << "\n========================= { Module: " << title << " } =========================\n\n";
+    std::vector<int> toWrap;
 
-        for( auto pair : allResults )
+    if(this->resident != nullptr)
+    {
+        for(auto module : this->designModules)
         {
-            plaintext << "\t" << pair.first.toString() << "\t<" << pair.second.first << " " << pair.second.second << ">\n";
+            this->moduleInterfaces.push_back(Incremental::ResidentState::interfaceOf(module));
+            this->moduleShapes.push_back(Incremental::ResidentState::shapeOf(module));
         }
 
-        plaintext << "\n";
+        this->resident->beginRun(this->moduleNames);
     }
-    //Condensing
-    else
+
+    if(!cacheDirectory.empty())
     {
-        plaintext << "\n========================= { Module: " << title << " } =========================\n\n";
+        this->cache.reset(new AnalysisCache::AnalysisCache(cacheDirectory));
+        this->moduleHashes = AnalysisCache::AnalysisCache::hashModules(design, this->designModules);
+    }
 
-        for( auto pair : mod->getSliceStructure())
+    for(int i = 0; i < moduleCount; i++)
+    {
+        if(this->resident != nullptr)
         {
-            plaintext << "\t" << pair.first.toString();
-            plaintext << " [";
+            std::unique_ptr<AnalysisCache::CachedModule> entry = this->resident->reuse(this->moduleNames[i], this->moduleInterfaces[i], this->moduleShapes[i]);
 
-            for( int i=(int)pair.second.size()-1; i>=0; i--)
+            if(entry != nullptr)
             {
-                plaintext << pair.second[i];
-
+                log("Module %s has not been edited since the last run, reusing its analysis.\n", this->moduleNames[i].c_str());
+                this->innerModules[i] = entry->innerModules;
+                this->cachedModules[i] = std::move(entry);
+                this->reusedModules[i] = 1;
+                continue;
             }
-
-            plaintext << "]\n";
-        }
-    }
-
-    return plaintext.str();
-}
-
-std::string DesignAnalyzer::DesignAnalyzer::prepareXML( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense )
-{
-    std::stringstream xml;
-    
-    //Not condensing
-    if(!condense)
-    {
-        xml << "<module>\n" << "\t<name>\n\t\t" << title << "\n\t</name>\n";
-        
-        for( auto pair : allResults )
-        {
-            xml << "\t<signal>\n";
-            xml << "\t\t<signalName>" << pair.first.toString() << "</signalName>\n";
-            xml << "\t\t<data>" << pair.second.first << "</data>\n";
-            xml << "\t\t<select>" << pair.second.second << "</select>\n";
-            xml << "\t</signal>\n";
         }
 
-        xml << "</module>\n";
-    }
-    //Condensing
-    else
-    {
-        xml << "<module>\n" << "\t<name>\n\t\t" << title << "\n\t</name>\n";
-        
-        for( auto pair : mod->getSliceStructure())
+        if(this->cache)
         {
-            xml << "\t<signal>\n";
-            xml << "\t\t<signalName>" << pair.first.toString() << "</signalName>\n";
-            xml << "\t\t<slice>";
+            std::unique_ptr<AnalysisCache::CachedModule> entry = this->cache->load(this->moduleHashes[i]);
 
-            for( int i=(int)pair.second.size()-1; i>=0; i--)
+            if(entry != nullptr && entry->moduleName == this->moduleNames[i])
             {
-                xml << pair.second[i];
+                log("Module %s is unchanged, using its cached analysis.\n", this->moduleNames[i].c_str());
+                this->innerModules[i] = entry->innerModules;
+                this->cachedModules[i] = std::move(entry);
+                continue;
             }
-
-            xml << "</slice>\n\t</signal>\n";
         }
 
-        xml << "</module>\n";
+        toWrap.push_back(i);
     }
 
-    return xml.str();
+    this->wrapModules(toWrap, threads);
 }
 
-std::string DesignAnalyzer::DesignAnalyzer::prepareJSON( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense )
+void DesignAnalyzer::DesignAnalyzer::wrapModules(const std::vector<int> &indexes, int threads)
 {
-    std::stringstream json;
-
-    //Not condensing
-    if(!condense)
+    if(indexes.empty())
     {
-        json << "{\"module\": {\n \"name\": \"" << title << "\",\n \"signals\": [\n";
-        
-        //Counter for JSON syntax
-        int counter = 0;
+        return;
+    }
 
-        for( auto pair : allResults )
-        {
+    //The shared cell repository must be complete before the workers start looking cells up
+    CellRepository::CellRepository::prepareConcurrentLookups();
 
-            json << "     {\"signalName\": \"" << pair.first.toString() << "\", \"data\": \"" << pair.second.first << "\", \"select\": \"" << pair.second.second << "\"}";
-        
-            if(counter < (int)allResults.size())
-            {
-                json << ",\n";
-            }
-            else
-            {
-                json << "\n";
-            }
+    ThreadPool::ThreadPool pool(threads);
+    //With more than one worker the build messages would interleave: each Generator keeps them until its turn comes
+    bool deferLog = pool.getThreads() > 1;
 
-            counter++;
-        }
+    //A failed build stops the others, and is reported here on the calling thread
+    std::string failure;
 
-        json << "   ]\n  }\n}\n";
-    }
-    //Condensing
-    else
+    try
     {
-        json << "{\"module\": {\n \"name\": \"" << title << "\",\n \"signals\": [\n";
-
-        for( auto pair : mod->getSliceStructure())
+        pool.runAll((int)indexes.size(), [&](int k)
         {
-            json << "     {\"signalName\": \"" << pair.first.toString() << "\", \"slice\": \"";
+            int i = indexes[k];
+            Profiler::ModuleScope profile(this->profiles[i]);
+            Trace::Span span("build", &this->moduleNames[i]);
+            this->wrappedModules[i] = this->wrapModule(this->designModules[i], deferLog);
 
-            for( int i=(int)pair.second.size()-1; i>=0; i--)
+            if(!this->wrappedModules[i]->isConsistent())
             {
-                json << pair.second[i];
+                throw std::runtime_error("The graph of module " + this->moduleNames[i] + " is inconsistent, cannot proceed.");
             }
+        });
+    }
+    catch(const std::runtime_error &e)
+    {
+        failure = e.what();
+    }
+
+    //Same order as the design, whatever the order the builds completed in
+    for(auto i : indexes)
+    {
+        Generator::Generator *gen = this->wrappedModules[i];
 
-            json << "\"}\n";
+        //Never started, the run stopped at a failure
+        if(gen == nullptr)
+        {
+            continue;
         }
 
-        json << "  }\n}\n";
+        gen->flushBuildLog();
+
+        this->innerModules[i].clear();
+        for(auto &inner : gen->getInnerModules())
+        {
+            this->innerModules[i].push_back(inner.second);
+        }
     }
 
-    return json.str();
+    if(!failure.empty())
+    {
+        log_error("%s\n", failure.c_str());
+    }
 }
 
-std::string DesignAnalyzer::DesignAnalyzer::prepareCSV( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense )
+void DesignAnalyzer::DesignAnalyzer::dropCachedModules(int threads)
 {
-    std::stringstream csv;
+    std::vector<int> toWrap;
 
-    //Not condensing
-    if(!condense)
+    for(int i = 0; i < (int)this->cachedModules.size(); i++)
     {
-        csv << "\"ModuleName\",\t\"signalName\",\t\"data\",\t\"select\"\n";
-    
-        for( auto pair : allResults )
+        if(this->cachedModules[i] != nullptr)
         {
-            csv << "\"" <<  title << "\",\t\"" << pair.first.toString() << "\",\t" << pair.second.first << ",\t" << pair.second.second << "\n";
+            this->cachedModules[i].reset();
+            this->reusedModules[i] = 0;
+            toWrap.push_back(i);
         }
     }
-    //Condensing
-    else
-    {
-        csv << "\"ModuleName\",\t\"signalName\",\t\"slice\"\n";
 
-        for( auto pair : mod->getSliceStructure())
-        {
-            csv << "\"" <<  title << "\",\t\"" << pair.first.toString() << "\",\t\"";
-            
-            for( int i=(int)pair.second.size()-1; i>=0; i--)
-            {
-                csv << pair.second[i];
-            }
-
-            csv << "\"\n";
-        }
-    }
-    
-    return csv.str();
+    this->wrapModules(toWrap, threads);
 }
 
-DesignAnalyzer::DesignAnalyzer::DesignAnalyzer(RTLIL::Design *design)
+DesignAnalyzer::DesignAnalyzer::~DesignAnalyzer()
 {
-    for(auto module : design->modules())
+    for(auto gen : this->wrappedModules)
     {
-        this->wrapModule(module);
+        delete gen;
     }
 }
 
@@ -255,6 +223,12 @@ void DesignAnalyzer::DesignAnalyzer::PRINT_allModules()
 {
     for(auto wa : this->wrappedModules)
     {
+        //Modules answered by the cache have no Generator
+        if(wa == nullptr)
+        {
+            continue;
+        }
+
         std::cout << wa->toString() << std::endl;
     }
 }
@@ -263,6 +237,11 @@ void DesignAnalyzer::DesignAnalyzer::PRINT_allModulesSupportGraphs()
 {
     for(auto wa : this->wrappedModules)
     {
+        if(wa == nullptr)
+        {
+            continue;
+        }
+
         std::cout << wa->getSupportGraph().toString() << std::endl;
     }
 }
@@ -271,6 +250,11 @@ void DesignAnalyzer::DesignAnalyzer::PRINT_CoupledSignals()
 {
     for(auto wa : this->wrappedModules)
     {
+        if(wa == nullptr)
+        {
+            continue;
+        }
+
         std::cout << "++++++{Module: " << wa->getModuleName() << "}++++++" << std::endl;
         
         for(auto cs : wa->getCoupledSignals())
@@ -20,6 +20,11 @@
 #ifndef DESIGNANALYZER_H
 #define DESIGNANALYZER_H
 
+//Standard libraries
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
 //Yosys libraries
 #include "kernel/yosys.h"
 #include "backends/ilang/ilang_backend.h"
@@ -32,6 +37,13 @@
 #include "generator_library.h"
 #include "generator_analyzer.h"
 #include "dfs.h"
+#include "module_summary.h"
+#include "thread_pool.h"
+#include "analysis_cache.h"
+#include "incremental.h"
+#include "result_writer.h"
+#include "profiler.h"
+#include "trace.h"
 
 USING_YOSYS_NAMESPACE
 
@@ -40,63 +52,72 @@ USING_YOSYS_NAMESPACE
  */
 namespace DesignAnalyzer
 {
-    /*
-     *  Struct that contains elaborated data to print in various settings.
-     */
-    struct Final_Results
-    {
-        std::string plaintext;
-        std::string xml;
-        std::string json;
-        std::string csv;
-    };
-
     class DesignAnalyzer
     {
         private:
-            Final_Results dfs_results;
-
-            //List of all the modules' wrapper
+            //Signal names of the run, dropped with the analyzer. First member: it goes after everything holding signals
+            Signal::NameScope names;
+            //List of all the modules' wrapper, nullptr for the modules answered by the analysis cache
             std::vector<Generator::Generator *> wrappedModules ;
-            
-            /*
-             *  Creation of wrapper modules
-             */
-            void wrapModule(RTLIL::Module *module);
-            
-            /*
-             *  Sorter for DFS' result vector
-             */
-            std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > sort( std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > toSort);
+            //Modules of the design and their names, in the same order
+            std::vector<RTLIL::Module *> designModules;
+            std::vector<std::string> moduleNames;
+            //Types of the module placeholders inside each module (see Generator::getInnerModules)
+            std::vector< std::vector<std::string> > innerModules;
+
+            //Analysis cache (nullptr if disabled), content hash of each module and the entries found for them
+            std::unique_ptr<AnalysisCache::AnalysisCache> cache;
+            std::vector<std::string> moduleHashes;
+            std::vector< std::unique_ptr<AnalysisCache::CachedModule> > cachedModules;
+
+            //State kept from the last run (nullptr if not incremental), interface and shape of each module, and which cached entries come from it
+            Incremental::ResidentState *resident;
+            std::vector<std::string> moduleInterfaces;
+            std::vector<std::string> moduleShapes;
+            std::vector<char> reusedModules;
 
+            //Profile of each module, all nullptr if the run is not being profiled
+            std::vector<Profiler::ModuleProfile *> profiles;
+            
             /*
-             *  Results are a list of strings. allResults must be passed through the sort() method beforehand to obtain organized results.
+             *  Creation of wrapper modules. With deferLog the build messages are kept in the Generator (see Generator::flushBuildLog).
              */
-            std::vector<std::string> prepareResults( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense=false );
+            Generator::Generator *wrapModule(RTLIL::Module *module, bool deferLog=false);
 
             /*
-             *  Prepare plaintext.
+             *  Builds the Generators of the modules in the given positions, on the given number of workers. Their build messages are logged in design order.
              */
-            std::string preparePlaintext( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense=false );
+            void wrapModules(const std::vector<int> &indexes, int threads);
 
             /*
-             *  Prepare XML
+             *  Drops the cached entries and builds the Generators they stood for, for the analyses the cache cannot answer.
              */
-            std::string prepareXML( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense=false );
+            void dropCachedModules(int threads);
             
             /*
-             *  Prepare JSON
+             *  Sorter for DFS' result vector
              */
-            std::string prepareJSON( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense=false );
+            std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > sort( std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > toSort);
+
+        public:
 
             /*
-             *  Prepare CSV
+             *  Wraps all the modules of the design, building their Generators on the given number of workers (0 = one per hardware thread).
+             *  With a cache directory, the modules whose content hash is found there are not wrapped: their stored analysis is used instead.
+             *  With a resident state, the same goes for the modules not edited since its last run; DFS() reanalyzes them only if one of their
+             *  inner modules changes summary, and leaves the new results in the state.
+             *  With a profiler, the phases and the counters of every module, building included, are added to it.
              */
-            std::string prepareCSV( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense=false );
+            DesignAnalyzer(RTLIL::Design *design, int threads=0, std::string cacheDirectory="", Incremental::ResidentState *resident=nullptr,
+                           Profiler::Profiler *profiler=nullptr);
 
-        public:
+            /*
+             *  The analyzer owns its Generators: destroying it frees the graphs of the whole design.
+             */
+            ~DesignAnalyzer();
 
-            DesignAnalyzer(RTLIL::Design *design);
+            DesignAnalyzer(const DesignAnalyzer &) = delete;
+            DesignAnalyzer &operator=(const DesignAnalyzer &) = delete;
             
             /*
              *  Method used for printing all the modules.
@@ -114,260 +135,409 @@ namespace DesignAnalyzer
             void PRINT_CoupledSignals();
             
             /*
-             *  Method used for printing the DFS of all the signals of the design.
+             *  Method used for printing the DFS of all the signals of the design. Each module goes to all the writers as soon as it and the ones
+             *  before it in the report are analyzed, so the output grows while the analysis runs.
              */
-            Final_Results DFS(bool enableDeepScan, bool condense=false, bool pt=false, bool xm=false, bool js=false, bool cs=false)
+            void DFS(bool enableDeepScan, const std::vector<ResultWriter::ResultWriter *> &writers, bool condense=false, bool componentReachability=true, bool laneSweep=false, bool conePruning=true, int threads=0)
             {
-                std::stringstream plaintext;
-                std::stringstream xml;
+                //La cache contiene solo analisi con deep scan: senza, servono i Generator di tutti i moduli
+                if(!enableDeepScan)
+                {
+                    this->dropCachedModules(threads);
+                }
+
+                int moduleCount = (int)this->wrappedModules.size();
 
-                if(condense)
+                //Riassunti dei moduli analizzati, condivisi da tutte le DFS di questa esecuzione. Indicizza anche i wrapped modules per nome
+                ModuleSummary::ModuleSummaryStore summaries(this->wrappedModules, this->moduleNames);
+
+                /*
+                 *  DAG delle istanze: un modulo può essere analizzato solo dopo tutti i moduli interni che istanzia.
+                 *  parents[c] sono i moduli che aspettano c, innerCount[i] il numero di moduli interni distinti di i.
+                 */
+                std::vector<std::vector<int>> parents(moduleCount);
+                std::vector<int> innerCount(moduleCount, 0);
+                for(int i = 0; i < moduleCount; i++)
                 {
-                    xml << "<condensed>\n";
+                    std::set<int> inner;
+
+                    for(auto &mn : this->innerModules[i])
+                    {
+                        int c = summaries.findModuleIndex(mn);
+
+                        if(c >= 0)
+                        {
+                            inner.insert(c);
+                        }
+                    }
+
+                    for(auto c : inner)
+                    {
+                        parents[c].push_back(i);
+                    }
+
+                    innerCount[i] = (int)inner.size();
                 }
-                else
+
+                //Nodi (di tutti i moduli) che istanziano ciascun modulo: sono quelli da aggiornare una volta analizzato
+                std::vector<std::vector<Graph_Node::Node *>> instances(moduleCount);
+                for(auto wa : this->wrappedModules)
                 {
-                    xml << "<wholesignals>\n";
+                    //I moduli presi dalla cache non vengono rianalizzati, i loro nodi non servono
+                    if(wa == nullptr)
+                    {
+                        continue;
+                    }
+
+                    for(auto node : wa->getSupportGraph().getNodes())
+                    {
+                        int c = summaries.findModuleIndex(node->getType());
+
+                        if(c >= 0)
+                        {
+                            instances[c].push_back(node);
+                        }
+                    }
                 }
 
-                std::stringstream json;
-                std::stringstream csv;
-                
-                std::vector<DFS::DFSDSS *> processedAtomicModules;
-                
-                bool goAhead = false;
-                bool found = false;
-                std::vector<Generator::Generator *> analyzedWrappedModules;
-                
-                //Analizzo i moduli in ordine di "atomicità"
-                do
+                /*
+                 *  Ordine dei risultati: è quello in cui li produceva l'analisi per passate successive sui wrapped modules, in cui un modulo
+                 *  viene analizzato nella prima passata in cui tutti i suoi moduli interni sono già stati analizzati.
+                 */
+                std::vector<int> reportOrder;
+                std::vector<bool> reported(moduleCount, false);
+                bool goAhead = true;
+                while(goAhead)
                 {
                     goAhead = false;
-                    
-                    //Guardo tra i miei wrapped modules
-                    for(auto wm : this->wrappedModules)
+
+                    for(int i = 0; i < moduleCount; i++)
+                    {
+                        if(reported[i])
+                        {
+                            continue;
+                        }
+
+                        bool canProcede = true;
+                        for(auto &mn : this->innerModules[i])
+                        {
+                            int c = summaries.findModuleIndex(mn);
+
+                            if(c >= 0 && !reported[c])
+                            {
+                                canProcede = false;
+                            }
+                        }
+
+                        if(canProcede)
+                        {
+                            reported[i] = true;
+                            reportOrder.push_back(i);
+                            goAhead = true;
+                        }
+                    }
+                }
+
+                /*
+                 *  Il report esce nell'ordine di reportOrder: un modulo viene scritto appena è pubblicato insieme a tutti quelli che lo precedono.
+                 *  reportLock protegge il cursore e serializza i writer, che possono essere chiamati da qualunque worker.
+                 */
+                std::mutex reportLock;
+                size_t nextReport = 0;
+
+                auto writeReady = [&](bool last)
+                {
+                    std::lock_guard<std::mutex> guard(reportLock);
+
+                    while(nextReport < reportOrder.size())
                     {
-                        found = false;
-                        
-                        //Per ognuno dei wrapped modules controllo che non siano già stati analizzati in fasi precedenti
-                        for(auto awm : analyzedWrappedModules)
+                        int i = reportOrder[nextReport];
+                        const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > *results = summaries.getResults(i);
+
+                        if(results == nullptr)
                         {
-                            if(awm == wm)
+                            //Moduli saltati perché parte di un ciclo: a fine analisi non li aspetta più nessuno
+                            if(!last)
                             {
-                                found = true ;
                                 break;
                             }
+
+                            nextReport++;
+                            continue;
+                        }
+
+                        nextReport++;
+
+                        std::string title = this->moduleNames[i] + " [Deep Scan: " ;
+                        if(enableDeepScan)
+                        {
+                            title += "-enabled- ]";
+                        }
+                        else
+                        {
+                            title += "-disabled- ]" ;
+                        }
+
+                        //Il report condensato usa solo la slice structure
+                        std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > sorted;
+                        if(!condense)
+                        {
+                            sorted = sort(*results);
+                        }
+
+                        //Il log condivide lo stdout con il writer del plaintext
+                        std::lock_guard<std::mutex> kernel(ThreadPool::kernelMutex());
+                        Profiler::ModuleScope profile(this->profiles[i]);
+                        Profiler::PhaseTimer timer(Profiler::PHASE_OUTPUT);
+                        Trace::Span span("output", &this->moduleNames[i]);
+
+                        for(auto writer : writers)
+                        {
+                            writer->writeModule(this->moduleNames[i], title, *summaries.getSliceStructure(i), sorted);
+                        }
+                    }
+                };
+
+                for(auto writer : writers)
+                {
+                    writer->begin();
+                }
+
+                //Le analisi dei moduli indipendenti non condividono nulla di modificabile, tranne le tabelle hash di Yosys
+                CellRepository::CellRepository::prepareConcurrentLookups();
+
+                ThreadPool::ThreadPool pool(threads);
+                //Voci della cache che non è stato possibile scrivere
+                std::atomic<int> cacheFailures(0);
+                //Dimensioni dei grafi analizzati, prima e dopo la potatura dei coni
+                std::atomic<long long> nodesBefore(0), nodesAfter(0), successorsBefore(0), successorsAfter(0), collapsed(0);
+
+                //Moduli che chi li istanzia potrebbe vedere in modo diverso dall'esecuzione precedente (solo in modalità incrementale)
+                std::vector<char> summaryChanged(moduleCount, 0);
+
+                //Setta su un nodo che istanzia il modulo c il ruolo di ogni sua porta
+                auto applyPortRoles = [&](Graph_Node::Node *node, int c)
+                {
+                    for(auto inputPort : node->getInputs())
+                    {
+                        //Per ogni porta del modulo , gli setto se è di selezione , data o entrambe
+                        int role = summaries.getPortRole(c, Signal::findName(inputPort->getPortName()));
+
+                        if(role > 0)
+                        {
+                            node->setModulePort(inputPort, (role & ModuleSummary::DATA_ROLE) != 0, (role & ModuleSummary::SELECT_ROLE) != 0);
+                        }
+                    }
+                };
+
+                //Analisi di un modulo: parte appena tutti i suoi moduli interni sono stati analizzati
+                auto analyze = [&](int i)
+                {
+                    Profiler::ModuleScope profile(this->profiles[i]);
+                    Generator::Generator *wm = this->wrappedModules[i];
+
+                    //Analisi dell'esecuzione precedente: vale solo se tutti i moduli interni si presentano come allora
+                    if(wm == nullptr && this->reusedModules[i])
+                    {
+                        bool innerChanged = false;
+
+                        for(auto &mn : this->innerModules[i])
+                        {
+                            int c = summaries.findModuleIndex(mn);
+
+                            if(c >= 0 && summaryChanged[c])
+                            {
+                                innerChanged = true;
+                            }
                         }
-                        
-                        //Non ho ancora analizzato il modulo
-                        if(!found)
+
+                        if(innerChanged)
                         {
-                            //Vettore di flag booleani che indica se abbiamo già esplorato un modulo interno
-                            std::vector<bool> exploredInnerModules ;
-                            //flag booleano che indica se possiamo procedere con l'analisi
-                            bool canProcede = true;
-                                
-                            //Verifico se il modulo non è atomico ma contiene altri moduli atomici precedentemente esplorati
-                            for(auto mn : wm->getInnerModules())
+                            bool deferLog = pool.getThreads() > 1;
                             {
-                                found = false ;
-                                    
-                                for(auto ppm : processedAtomicModules)
-                                {
-                                    //Se il modulo interno è tra quelli già esplorati lo setto a true
-                                    if(mn.second == ppm->getTargetModule()->getModuleName())
-                                    {
-                                        found = true;
-                                    }
-                                }
-                                    
-                                //Aggiungo se il modulo interno è già stato esplorato
-                                exploredInnerModules.push_back(found);
+                                Trace::Span span("build", &this->moduleNames[i]);
+                                wm = this->wrapModule(this->designModules[i], deferLog);
                             }
-                                
-                            //Verifico se vi sono moduli interni non ancora esplorati
-                            for(auto eim : exploredInnerModules)
+
+                            if(deferLog)
                             {
-                              //Se è così non posso procedere 
-                              if(!eim)
-                              {
-                                   canProcede = false;
-                              }
+                                std::lock_guard<std::mutex> guard(ThreadPool::kernelMutex());
+                                wm->flushBuildLog();
                             }
-                                
-                            //Se non posso procedere , vedrò al prossimo ciclo
-                            if(!canProcede)
+
+                            this->wrappedModules[i] = wm;
+                            this->cachedModules[i].reset();
+
+                            //Il pool ferma l'analisi, l'errore viene dato dal thread principale
+                            if(!wm->isConsistent())
                             {
-                                goAhead = true;
+                                throw std::runtime_error("The graph of module " + this->moduleNames[i] + " is inconsistent, cannot proceed.");
                             }
-                            //Posso procedere -> tutti i moduli interni sono già stati esplorati
-                            else
+
+                            //I nodi del nuovo Generator non sono tra le istanze raccolte prima: i moduli interni sono già tutti pubblicati
+                            for(auto node : wm->getSupportGraph().getNodes())
                             {
-                                //Verifico lo stato dei segnali del nodo attuale
-                                DFS::DFS dfs(wm, this->wrappedModules, enableDeepScan);
-                                //dfs.setPreviouslyProcessedModules(processedAtomicModules);
-                                std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > results = dfs.DFS_FTSA(false);
-                                
-                        
-                                DFS::DFSDSS *newRes = new DFS::DFSDSS(wm);
-                                newRes->setPreviouslyProcessedResults(results);
-                                //processedAtomicModules = VectorSupport::merge(processedAtomicModules, newRes);
-                                bool isIn = false;
-                                
-                                //Verifico di non aver già inserito il modulo all'interno di quelli visitati in precedenza
-                                for(auto pam : processedAtomicModules)
-                                {
-                                    if(pam->getTargetModule() == newRes->getTargetModule())
-                                    {
-                                        isIn = true;
-                                    }
-                                }
-                                
-                                //Se non l'ho già visitato, procedo
-                                if(!isIn)
-                                {
-                                   processedAtomicModules.push_back(newRes);
-                                }
-                                
-                                //processedAtomicModules.push_back(newRes);
-                                
-                                //Vettore di segnali su cui è già stato effettuato l'AND bit a bit
-                                std::vector<std::pair<std::string, std::pair<bool, bool>>> exploredSignals;
-                                //Segnali analizzati
-                                std::vector<Signal::Signal> analyzedSignals ;
-                                
-                                //Verifico se ho già analizzato tutti i segnali di un certo tipo
-                                for(auto sigs : newRes->getPreviouslyProcessedResults())
-                                {
-                                   
-                                    bool explored = false;
-                                    
-                                    for(auto as : analyzedSignals)
-                                    {
-                                        //Se il segnale è già stato analizzato posso procedere oltre
-                                        if(as == sigs.first)
-                                        {
-                                            explored = true;
-                                            break;
-                                        }
-                                    }
-                                    
-                                    //Nel caso un segnale non fosse stato ancora analizzato, procedo con l'AND bit a bit ...
-                                    if(!explored)
-                                    {
-                                        explored = false;
-                                        
-                                        //Verifico se sono presenti altri segnali dello stesso tipo e , se si , aggiorno lo stato di tali segnali
-                                        for(auto es : exploredSignals)
-                                        {
-                                            if(es.first.compare(sigs.first.getSignalName()) == 0)
-                                            {
-                                                
-                                                es.second.first = es.second.first || sigs.second.first;
-                                                es.second.second = es.second.second || sigs.second.second;
-                                                
-                                                explored = true;
-                                                break;
-                                            }
-                                        
-                                        }
-                                        
-                                        //Inserisco una nuova enty con il nuovo valore
-                                        if(!explored)
-                                        {
-                                            std::pair<bool, bool> dataSelect = std::make_pair(sigs.second.first, sigs.second.second);
-                                            std::pair<std::string, std::pair<bool, bool>> signalState = std::make_pair(sigs.first.getSignalName(), dataSelect);
-                                            exploredSignals.push_back(signalState);
-                                        }
-                                        
-                                    }
-                                }
-                                
-                                //Aggiorno tutti i nodi dei moduli che fanno riferimento al nodo module appena trovato
-                                for(auto wa : this->wrappedModules)
+                                int c = summaries.findModuleIndex(node->getType());
+
+                                if(c >= 0)
                                 {
-                                    for(auto node : wa->getSupportGraph().getNodes())
-                                    {
-                                        //Vado ad aggiornare tutti i nodi che hanno a che vedere con questo modulo interno appena processato
-                                        if(node->getType().compare(newRes->getTargetModule()->getModuleName()) == 0)
-                                        {
-                                            for(auto inputPort : node->getInputs())
-                                            {
-                                                for(auto exploredSignal : exploredSignals)
-                                                {
-                                                    //Per ogni porta del modulo , gli setto se è di selezione , data o entrambe
-                                                    if(inputPort->getPortName().compare(exploredSignal.first) == 0)
-                                                    {
-                                                            
-                                                        //std::cout << "node: " << node->getType() << "port: " << inputPort->getPortName() << " signal: " << exploredSignal.first << " data = " << std::to_string(exploredSignal.second.first) << " selection: " << std::to_string(exploredSignal.second.second) << std::endl;
-                                                        node->setModulePort(inputPort,exploredSignal.second.first,exploredSignal.second.second);
-                                                       
-                                                    }
-                                                    
-                                                }
-                                            }
-                                        }
-                                    }
+                                    applyPortRoles(node, c);
                                 }
                             }
-                                
-                            
                         }
                     }
-                    
-                }while(goAhead);
-                
 
-                for(auto pam : processedAtomicModules)
-                {
-                    std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > results = pam->getPreviouslyProcessedResults();
-                    
-                    std::string title = pam->getTargetModule()->getModuleName() + " [Deep Scan: " ;
-                    if(enableDeepScan)
+                    if(wm == nullptr)
                     {
-                        title += "-enabled- ]";
+                        //Modulo invariato: i risultati salvati valgono come quelli della DFS
+                        summaries.publish(i, this->cachedModules[i]->results, this->cachedModules[i]->sliceStructure);
                     }
                     else
                     {
-                        title += "-disabled- ]" ;
-                    }
-                    
-                    //std::vector<std::string> prepareResults( std::string title, Generator::Generator *mod, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > allResults, bool condense=false )
-                    std::vector<std::string> fr = prepareResults( title,  pam->getTargetModule(), sort(results), condense );
-                    
-                    if(pt)
-                    {
-                        plaintext << fr[0] << "\n";
-                    }
-                    if(xm)
-                    {
-                        xml << fr[1];
+                        //Verifico lo stato dei segnali del nodo attuale
+                        DFS::DFS dfs(wm, &summaries, enableDeepScan);
+                        if(!componentReachability)
+                        {
+                            dfs.disableComponentReachability();
+                        }
+                        if(laneSweep)
+                        {
+                            dfs.enableLaneSweep();
+                        }
+                        if(!conePruning)
+                        {
+                            dfs.disablePruning();
+                        }
+
+                        //Il riassunto tiene, per ogni porta del modulo, il risultato del primo segnale con il suo nome
+                        std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > results;
+                        {
+                            Profiler::PhaseTimer timer(Profiler::PHASE_DFS_FTSA);
+                            Trace::Span span("DFS_FTSA", &this->moduleNames[i]);
+                            results = dfs.DFS_FTSA(false);
+                        }
+
+                        const SupportGraph::PruneStats &pruned = dfs.getPruneStats();
+                        nodesBefore += pruned.nodesBefore;
+                        nodesAfter += pruned.nodesAfter;
+                        successorsBefore += pruned.successorsBefore;
+                        successorsAfter += pruned.successorsAfter;
+                        collapsed += pruned.collapsed;
+                        summaries.publish(i, std::move(results), wm->getSliceStructure());
+
+                        if(this->cache && enableDeepScan)
+                        {
+                            AnalysisCache::CachedModule entry;
+                            entry.moduleName = this->moduleNames[i];
+                            entry.innerModules = this->innerModules[i];
+                            entry.results = *summaries.getResults(i);
+                            entry.sliceStructure = *summaries.getSliceStructure(i);
+
+                            if(!this->cache->store(this->moduleHashes[i], entry))
+                            {
+                                cacheFailures++;
+                            }
+                        }
                     }
-                    if(js)
+
+                    //Un'analisi riusata così com'era non è cambiata per costruzione
+                    if(this->resident != nullptr && !(this->reusedModules[i] && this->cachedModules[i] != nullptr))
                     {
-                        json << fr[2] << "\n";
+                        summaryChanged[i] = this->resident->summaryChanged(this->moduleNames[i], this->moduleInterfaces[i], *summaries.getResults(i));
                     }
-                    if(cs)
+
+                    //Aggiorno i nodi che istanziano il modulo appena processato: appartengono a moduli che lo aspettano, nessuno li sta leggendo
                     {
-                        csv << fr[3] << "\n";
+                        Profiler::PhaseTimer timer(Profiler::PHASE_DEEP_SCAN);
+
+                        for(auto node : instances[i])
+                        {
+                            applyPortRoles(node, i);
+                        }
                     }
+
+                    writeReady(false);
+                };
+
+                std::vector<int> skipped;
+                std::string failure;
+
+                try
+                {
+                    skipped = pool.runGraph(parents, innerCount, analyze);
+                }
+                catch(const std::runtime_error &e)
+                {
+                    failure = e.what();
+                }
+
+                if(!failure.empty())
+                {
+                    log_error("%s\n", failure.c_str());
+                }
+
+                writeReady(true);
+
+                for(auto writer : writers)
+                {
+                    writer->end();
+                }
+
+                for(auto i : skipped)
+                {
+                    log("Module %s is part of an instantiation cycle, skipping it.\n", this->moduleNames[i].c_str());
                 }
 
-                if(condense)
+                if(conePruning && nodesBefore > 0)
                 {
-                    xml << "</condensed>";
+                    log("Cone pruning: kept %lld of %lld nodes and %lld of %lld edges, %lld pass-through cells collapsed.\n",
+                        nodesAfter.load(), nodesBefore.load(), successorsAfter.load(), successorsBefore.load(), collapsed.load());
                 }
-                else
+
+                if(cacheFailures > 0)
                 {
-                    xml << "</wholesignals>";
+                    log_warning("Could not write %d entries of the analysis cache in %s.\n", cacheFailures.load(), this->cache->getDirectory().c_str());
                 }
 
-                dfs_results.plaintext = plaintext.str();
-                dfs_results.xml = xml.str();
-                dfs_results.json = json.str();
-                dfs_results.csv = csv.str();
+                //Lo stato residente conserva i risultati per la prossima esecuzione, che rianalizzerà solo i moduli modificati nel frattempo
+                if(this->resident != nullptr && enableDeepScan)
+                {
+                    std::set<std::string> recorded;
+                    int analyzed = 0;
+
+                    for(int i = 0; i < moduleCount; i++)
+                    {
+                        if(!summaries.isSummarized(i))
+                        {
+                            continue;
+                        }
+
+                        recorded.insert(this->moduleNames[i]);
 
-                return dfs_results;
+                        //Già nello stato così com'è
+                        if(this->reusedModules[i] && this->cachedModules[i] != nullptr)
+                        {
+                            continue;
+                        }
+
+                        AnalysisCache::CachedModule entry;
+                        entry.moduleName = this->moduleNames[i];
+                        entry.innerModules = this->innerModules[i];
+                        entry.results = *summaries.getResults(i);
+                        entry.sliceStructure = *summaries.getSliceStructure(i);
+
+                        this->resident->record(entry, this->moduleInterfaces[i], this->moduleShapes[i]);
+
+                        if(this->wrappedModules[i] != nullptr)
+                        {
+                            analyzed++;
+                        }
+                    }
+
+                    this->resident->endRun(recorded);
+
+                    log("Incremental analysis: %d of %d modules analyzed again.\n", analyzed, moduleCount);
+                }
             }
     };
 }
@@ -19,206 +19,546 @@
 
 #include "generator_library.h"
 #include "dfs.h"
+#include "profiler.h"
 
-DFS::DFSDSS::DFSDSS(Generator::Generator *targetModule)
+//The AVX2 merge is compiled for its own target and picked at run time, so the plugin does not need -mavx2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SANS_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+
+//OR-merges the lanes of source into target, true if target got a new lane
+static bool mergeLanes(const uint64_t *source, uint64_t *target)
 {
-    this->targetModule = targetModule;
+    bool grown = false;
+
+    for(int w = 0; w < DFS::DFSEngine::LANE_WORDS; w++)
+    {
+        if(source[w] & ~target[w])
+        {
+            target[w] |= source[w];
+            grown = true;
+        }
+    }
+
+    return grown;
 }
 
-void DFS::DFSDSS::setPreviouslyProcessedResults(std::vector< std::pair<Signal::Signal, std::pair<bool, bool>>> previouslyProcessedResults)
+#ifdef SANS_AVX2_DISPATCH
+static_assert(DFS::DFSEngine::LANE_WORDS == 4, "the AVX2 merge handles four words");
+
+__attribute__((target("avx2"))) static bool mergeLanesAvx2(const uint64_t *source, uint64_t *target)
 {
-    this->previouslyProcessedResults = previouslyProcessedResults;
+    __m256i s = _mm256_loadu_si256((const __m256i *)source);
+    __m256i t = _mm256_loadu_si256((const __m256i *)target);
+    __m256i fresh = _mm256_andnot_si256(t, s);
+
+    if(_mm256_testz_si256(fresh, fresh))
+    {
+        return false;
+    }
+
+    _mm256_storeu_si256((__m256i *)target, _mm256_or_si256(t, s));
+    return true;
 }
+#endif
+
+DFS::DFSEngine::DFSEngine(SupportGraph::SupportGraph &sg) : graph(sg)
+{
+    this->visitStamp.assign(this->graph.getNodeIdBound(), 0);
 
-Generator::Generator* DFS::DFSDSS::getTargetModule() { return this->targetModule; }
+    Profiler::peak(Profiler::COUNTER_PEAK_NODES, this->graph.getNodeOrder().size());
+    Profiler::peak(Profiler::COUNTER_PEAK_EDGES, this->graph.getSuccessorCount());
+}
 
-std::vector< std::pair<Signal::Signal, std::pair<bool, bool>>> DFS::DFSDSS::getPreviouslyProcessedResults()
+void DFS::DFSEngine::beginTraversal(int startId)
 {
-    return this->previouslyProcessedResults;
+    this->visitEpoch++;
+
+    //Wrap around: stamps of old traversals could collide with the new epochs
+    if(this->visitEpoch == 0)
+    {
+        std::fill(this->visitStamp.begin(), this->visitStamp.end(), 0);
+        this->visitEpoch = 1;
+    }
+
+    this->workStack.clear();
+    this->workStack.push_back(startId);
+    this->markVisited(startId);
 }
 
-bool DFS::DFS::DFS_MooreCorrection( Signal::Signal signal )
+bool DFS::DFSEngine::markVisited(int id)
 {
-	bool toCorrect = false;
+    unsigned int &stamp = this->visitStamp[id];
 
-	for( auto node : currentModule->startingNodes_byNameOnly(signal, false) )
-	{
-		if(toCorrect)
-		{
-			break;
-		}
+    if(stamp == this->visitEpoch)
+    {
+        return false;
+    }
 
-		for( auto inputPort : node->getInputs() )
-		{
-			if(!node->isModulePlaceholder())
-			{
-				//If it's a selection port
-				if( VectorSupport::isIn( (cr->getCell(node->getType()))->getSelectionInputs(), inputPort->getPortName() ) )
-				{
-					if( Signal::isIn_byNameOnly( inputPort->getInputSignals(), signal ) )
-					{
-						toCorrect = true;
-					}
-				}
-			}
-			
-		}
-	}
+    stamp = this->visitEpoch;
+    return true;
+}
 
-	return toCorrect;
+bool DFS::DFSEngine::follows(int successor, bool dataEdgesOnly)
+{
+    return !dataEdgesOnly || (this->graph.getSuccessorFlags(successor) & SupportGraph::EDGE_DATA);
 }
 
-void DFS::DFS::DFS_Data( Graph_Node::Node *currentNode, std::vector<bool> visited, bool &data )
+bool DFS::DFSEngine::entersSelection(int successor, bool deepScanEnabled)
 {
-	//Mark current node as visited
-	visited[ currentNode->getId() ] = true;
-    
-    SupportGraph::SupportGraph sg = this->currentModule->getSupportGraph();
+    unsigned char flags = this->graph.getSuccessorFlags(successor);
 
-	if( currentNode->isEmitter() )
-	{
-		data = true;
-	}
+    return (flags & SupportGraph::EDGE_SELECTION) || (deepScanEnabled && (flags & SupportGraph::EDGE_MODULE_SELECTION));
+}
 
-	for( auto reachedNode : sg.allNextNodes(currentNode, true) )
-	{
-		//If data was already set, it's useless to proceed.
-		if(data)
-		{
-			break;
-		}
+bool DFS::DFSEngine::reachesEmitter(Graph_Node::Node *startNode)
+{
+    if(this->summarized)
+    {
+        return this->dataReach[startNode->getId()];
+    }
 
-		if( !visited[reachedNode->getId() ] )
-		{
-			DFS_Data(reachedNode, visited, data);
-		}
-	}
+    this->beginTraversal(startNode->getId());
+    Profiler::count(Profiler::COUNTER_TRAVERSALS, 1);
+    //The profile is updated once per traversal, outside the loop
+    long long visited = 0;
+    long long scanned = 0;
+
+    while(!this->workStack.empty())
+    {
+        int currentId = this->workStack.back();
+        this->workStack.pop_back();
+        visited++;
+
+        if(this->graph.isEmitter(currentId))
+        {
+            Profiler::count(Profiler::COUNTER_NODES_VISITED, visited);
+            Profiler::count(Profiler::COUNTER_EDGES_SCANNED, scanned);
+            return true;
+        }
+
+        scanned += this->graph.successorsEnd(currentId) - this->graph.successorsBegin(currentId);
+
+        //Only data ports let the signal through
+        for(int next = this->graph.successorsBegin(currentId); next < this->graph.successorsEnd(currentId); next++)
+        {
+            int nextId = this->graph.getSuccessorNode(next);
+
+            if(this->follows(next, true) && this->markVisited(nextId))
+            {
+                this->workStack.push_back(nextId);
+            }
+        }
+    }
+
+    Profiler::count(Profiler::COUNTER_NODES_VISITED, visited);
+    Profiler::count(Profiler::COUNTER_EDGES_SCANNED, scanned);
+
+    return false;
 }
 
-void DFS::DFS::DFS_Select( Graph_Node::Node *currentNode, std::vector<bool> visited, bool &select )
+bool DFS::DFSEngine::reachesSelection(Graph_Node::Node *startNode, bool deepScanEnabled)
 {
-	//Mark current node as visited
-	visited[ currentNode->getId() ] = true;
-    
-    SupportGraph::SupportGraph sg = this->currentModule->getSupportGraph();
+    if(this->summarized && this->summaryDeepScan == deepScanEnabled)
+    {
+        return this->selectReach[startNode->getId()];
+    }
 
-        //Foreach port that goes out
-        for( auto currentNodePort : currentNode->getOutputs() )
+    this->beginTraversal(startNode->getId());
+    Profiler::count(Profiler::COUNTER_TRAVERSALS, 1);
+    long long visited = 0;
+    long long scanned = 0;
+
+    while(!this->workStack.empty())
+    {
+        int currentId = this->workStack.back();
+        this->workStack.pop_back();
+        visited++;
+        scanned += this->graph.successorsEnd(currentId) - this->graph.successorsBegin(currentId);
+
+        for(int next = this->graph.successorsBegin(currentId); next < this->graph.successorsEnd(currentId); next++)
         {
-            if(select)
+            if(this->entersSelection(next, deepScanEnabled))
             {
-                break;
+                Profiler::count(Profiler::COUNTER_NODES_VISITED, visited);
+                Profiler::count(Profiler::COUNTER_EDGES_SCANNED, scanned);
+                return true;
             }
-            
 
-            //Take the next nodes without discriminating
-            for( auto nextNode : sg.nextNodes(currentNode, currentNodePort, false) )
+            int nextId = this->graph.getSuccessorNode(next);
+
+            if(this->markVisited(nextId))
+            {
+                this->workStack.push_back(nextId);
+            }
+        }
+    }
+
+    Profiler::count(Profiler::COUNTER_NODES_VISITED, visited);
+    Profiler::count(Profiler::COUNTER_EDGES_SCANNED, scanned);
+
+    return false;
+}
+
+void DFS::DFSEngine::sweepComponents(bool dataEdgesOnly, const std::vector<char> &nodeFlag, std::vector<char> &reach)
+{
+    int bound = (int)nodeFlag.size();
+    std::vector<int> index(bound, -1);
+    std::vector<int> lowLink(bound, 0);
+    std::vector<int> component(bound, -1);
+    std::vector<char> onStack(bound, 0);
+    std::vector<int> componentStack;
+    std::vector<int> members;
+    //Explicit call stack: node being expanded and position among its successors
+    std::vector< std::pair<int, int> > callStack;
+    int nextIndex = 0;
+    int nextComponent = 0;
+    long long scanned = 0;
+
+    reach.assign(bound, 0);
+
+    for(int root : this->graph.getNodeOrder())
+    {
+        if(index[root] >= 0)
+        {
+            continue;
+        }
+
+        index[root] = lowLink[root] = nextIndex++;
+        componentStack.push_back(root);
+        onStack[root] = 1;
+        callStack.push_back(std::make_pair(root, this->graph.successorsBegin(root)));
+
+        while(!callStack.empty())
+        {
+            int id = callStack.back().first;
+            int &cursor = callStack.back().second;
+            int last = this->graph.successorsEnd(id);
+            bool descended = false;
+
+            for(; cursor != last; cursor++)
             {
-                
-                for( auto nextPortPair : /* std::vector<Graph_Node::Port *> */ sg.reachedPorts(currentNode, currentNodePort, nextNode) )
+                scanned++;
+
+                if(!this->follows(cursor, dataEdgesOnly))
+                {
+                    continue;
+                }
+
+                int nextId = this->graph.getSuccessorNode(cursor);
+
+                if(index[nextId] < 0)
+                {
+                    //Descend: the cursor is advanced now, the child is the new top of the stack
+                    cursor++;
+                    index[nextId] = lowLink[nextId] = nextIndex++;
+                    componentStack.push_back(nextId);
+                    onStack[nextId] = 1;
+                    callStack.push_back(std::make_pair(nextId, this->graph.successorsBegin(nextId)));
+                    descended = true;
+                    break;
+                }
+                else if(onStack[nextId])
+                {
+                    lowLink[id] = std::min(lowLink[id], index[nextId]);
+                }
+            }
+
+            if(descended)
+            {
+                continue;
+            }
+
+            //All successors done: close the component if id is its root, then return to the parent
+            if(lowLink[id] == index[id])
+            {
+                int member = -1;
+                members.clear();
+
+                do
                 {
-                    if(!nextNode->isModulePlaceholder())
+                    member = componentStack.back();
+                    componentStack.pop_back();
+                    onStack[member] = 0;
+                    component[member] = nextComponent;
+                    members.push_back(member);
+                }
+                while(member != id);
+
+                char value = 0;
+
+                for(int m : members)
+                {
+                    if(value)
                     {
-                        //std::cout << "checking if the cell is a selection port" << std::endl;
-                        //std::cout << "node: " << nextNode->getType() << " port:" << nextPortPair.first->getPortName() << std::endl;
-                        if( VectorSupport::isIn( (cr->getCell(nextNode->getType()))->getSelectionInputs(), nextPortPair.first->getPortName() ) )
-                        {
-                            select = true;
-                        }
+                        break;
                     }
-                    else
+
+                    value = nodeFlag[m];
+
+                    for(int next = this->graph.successorsBegin(m); next < this->graph.successorsEnd(m) && !value; next++)
                     {
-                        if(deepScanEnabled && VectorSupport::isIn(nextNode->getModuleSelectionPorts(), nextPortPair.first))
+                        int nextId = this->graph.getSuccessorNode(next);
+
+                        if(component[nextId] != nextComponent && this->follows(next, dataEdgesOnly))
                         {
-                            select = true;
+                            value = reach[nextId];
                         }
                     }
-                } 
+                }
+
+                for(int m : members)
+                {
+                    reach[m] = value;
+                }
+
+                nextComponent++;
+            }
+
+            callStack.pop_back();
+
+            if(!callStack.empty())
+            {
+                int parentId = callStack.back().first;
+                lowLink[parentId] = std::min(lowLink[parentId], lowLink[id]);
             }
-            
         }
+    }
 
-	for( auto reachableNode : sg.allNextNodes(currentNode, false))
-	{
-		if( !visited[reachableNode->getId()] )
-		{
-			DFS_Select( reachableNode, visited, select );
-		}
-	}
+    //Every node gets an index exactly once
+    Profiler::count(Profiler::COUNTER_TRAVERSALS, 1);
+    Profiler::count(Profiler::COUNTER_NODES_VISITED, nextIndex);
+    Profiler::count(Profiler::COUNTER_EDGES_SCANNED, scanned);
 }
 
-std::pair<bool, bool> DFS::DFS::DFS_DeepScan( Graph_Node::Node *analyzedNode,Graph_Port::Port *analyzedPort )
+void DFS::DFSEngine::nodeFlags(bool deepScanEnabled, std::vector<char> &isEmitter, std::vector<char> &entersSelection)
 {
-    std::pair<bool,bool> result = std::make_pair(false, false);
-    bool found = false;
-    std::vector< std::pair<Signal::Signal, std::pair<bool, bool>>> res ;
-    
-    Generator::Generator *analyzedNodeModule = nullptr;
-    
-    //Here we are searching for the analyzedNode Generator among our list
-    for(auto mw : this->designModules)
+    int bound = this->graph.getNodeIdBound();
+    isEmitter.assign(bound, 0);
+    entersSelection.assign(bound, 0);
+
+    for(int id : this->graph.getNodeOrder())
     {
-        if(mw->getModuleName() == analyzedNode->getType())
+        isEmitter[id] = this->graph.isEmitter(id);
+
+        for(int next = this->graph.successorsBegin(id); next < this->graph.successorsEnd(id); next++)
         {
-            analyzedNodeModule = mw;
-            found = true;
+            if(this->entersSelection(next, deepScanEnabled))
+            {
+                entersSelection[id] = 1;
+                break;
+            }
         }
-        
-        if(found)
+    }
+}
+
+void DFS::DFSEngine::summarizeComponents(bool deepScanEnabled)
+{
+    std::vector<char> isEmitter;
+    std::vector<char> entersSelection;
+
+    //Properties of the single nodes, the sweeps propagate them backwards through the components
+    this->nodeFlags(deepScanEnabled, isEmitter, entersSelection);
+
+    this->summarized = false;
+    this->sweepComponents(true, isEmitter, this->dataReach);
+    this->sweepComponents(false, entersSelection, this->selectReach);
+    this->summaryDeepScan = deepScanEnabled;
+    this->summarized = true;
+}
+
+SupportGraph::PruneStats DFS::DFSEngine::pruneCones(const std::vector<int> &seeds, bool deepScanEnabled)
+{
+    this->summarized = false;
+
+    return this->graph.pruneCones(seeds, deepScanEnabled);
+}
+
+void DFS::DFSEngine::propagateBatch(const std::vector< std::vector<Graph_Node::Node *> > &laneSeeds, size_t firstLane, size_t lanes, bool dataEdgesOnly,
+                                    const std::vector<char> &nodeFlag, std::vector<char> &laneResult)
+{
+    int bound = this->graph.getNodeIdBound();
+    std::vector<uint64_t> masks((size_t)bound * LANE_WORDS, 0);
+    std::vector<char> queued(bound, 0);
+    std::vector<int> &worklist = this->workStack;
+
+    worklist.clear();
+
+    for(size_t lane = 0; lane < lanes; lane++)
+    {
+        for(auto seed : laneSeeds[firstLane + lane])
         {
-            break;
+            int seedId = seed->getId();
+            masks[(size_t)seedId * LANE_WORDS + lane / 64] |= (uint64_t)1 << (lane % 64);
+
+            if(!queued[seedId])
+            {
+                queued[seedId] = 1;
+                worklist.push_back(seedId);
+            }
         }
     }
-    
-    found = false;
 
-    //Looking if we already have the results for tracking related to the current analyzed module
-    for(auto pps : this->previouslyProcessedModules)
+    long long visited = 0;
+    long long scanned = 0;
+    bool (*merge)(const uint64_t *, uint64_t *) = mergeLanes;
+
+#ifdef SANS_AVX2_DISPATCH
+    if(__builtin_cpu_supports("avx2"))
     {
-        if((pps->getTargetModule() == analyzedNodeModule))
+        merge = mergeLanesAvx2;
+    }
+#endif
+
+    //Fixpoint: a node is queued again only when one of its lanes is new, so every lane crosses every edge at most once
+    while(!worklist.empty())
+    {
+        int currentId = worklist.back();
+        worklist.pop_back();
+        queued[currentId] = 0;
+        visited++;
+        scanned += this->graph.successorsEnd(currentId) - this->graph.successorsBegin(currentId);
+
+        const uint64_t *source = &masks[(size_t)currentId * LANE_WORDS];
+
+        for(int next = this->graph.successorsBegin(currentId); next < this->graph.successorsEnd(currentId); next++)
         {
-            res = pps->getPreviouslyProcessedResults();
-            found = true;
+            if(!this->follows(next, dataEdgesOnly))
+            {
+                continue;
+            }
+
+            int nextId = this->graph.getSuccessorNode(next);
+            uint64_t *target = &masks[(size_t)nextId * LANE_WORDS];
+
+            if(merge(source, target) && !queued[nextId])
+            {
+                queued[nextId] = 1;
+                worklist.push_back(nextId);
+            }
         }
-        
-        if(found)
+    }
+
+    Profiler::count(Profiler::COUNTER_TRAVERSALS, 1);
+    Profiler::count(Profiler::COUNTER_NODES_VISITED, visited);
+    Profiler::count(Profiler::COUNTER_EDGES_SCANNED, scanned);
+
+    //A lane is answered by the union of the masks of the flagged nodes
+    uint64_t hit[LANE_WORDS] = {0};
+
+    for(int id : this->graph.getNodeOrder())
+    {
+        if(nodeFlag[id])
         {
-            break;
+            for(int w = 0; w < LANE_WORDS; w++)
+            {
+                hit[w] |= masks[(size_t)id * LANE_WORDS + w];
+            }
         }
     }
-    
-    if(!found)
+
+    for(size_t lane = 0; lane < lanes; lane++)
     {
-        DFS dfs(analyzedNodeModule, this->designModules);
-        dfs.enableDeepScan();
-        dfs.setPreviouslyProcessedModules(this->previouslyProcessedModules);
-        //Here we are performing the DFS on the inner node, performing the deepscan indeed
-        res = dfs.DFS_FTSA(false);
-        
-        DFSDSS *newRes = new DFSDSS(analyzedNodeModule);
-        newRes->setPreviouslyProcessedResults(res);
-        
-        this->previouslyProcessedModules.push_back(newRes);
+        laneResult[firstLane + lane] = (hit[lane / 64] >> (lane % 64)) & 1;
     }
-    
-    found = false;
-    
-    //Here we cycle the signals that the previous operations in order to checking if some of them is referred to the current port 
-    for(auto s : res)
+}
+
+void DFS::DFSEngine::propagateLanes(const std::vector< std::vector<Graph_Node::Node *> > &dataSeeds, const std::vector< std::vector<Graph_Node::Node *> > &selectSeeds,
+                                    bool deepScanEnabled, std::vector<char> &dataResult, std::vector<char> &selectResult)
+{
+    std::vector<char> isEmitter;
+    std::vector<char> entersSelection;
+
+    this->nodeFlags(deepScanEnabled, isEmitter, entersSelection);
+
+    dataResult.assign(dataSeeds.size(), 0);
+    selectResult.assign(selectSeeds.size(), 0);
+
+    //Data plane: only data ports let the signal through
+    for(size_t firstLane = 0; firstLane < dataSeeds.size(); firstLane += LANE_BITS)
     {
-        if(s.first.getSignalName() == analyzedPort->getPortName())
-        {
-            result.first = result.first || s.second.first;
-            result.second = result.second || s.second.second;
-            found = true;
-        }
-        
-        if(found)
+        this->propagateBatch(dataSeeds, firstLane, std::min((size_t)LANE_BITS, dataSeeds.size() - firstLane), true, isEmitter, dataResult);
+    }
+
+    //Select plane: every edge is followed
+    for(size_t firstLane = 0; firstLane < selectSeeds.size(); firstLane += LANE_BITS)
+    {
+        this->propagateBatch(selectSeeds, firstLane, std::min((size_t)LANE_BITS, selectSeeds.size() - firstLane), false, entersSelection, selectResult);
+    }
+}
+
+bool DFS::DFS::DFS_MooreCorrection( Signal::Signal signal )
+{
+	bool toCorrect = false;
+
+	//Ports where the signal enters (in name)
+	for( auto &consumer : currentModule->getSignalConsumers(signal.getSignalId()) )
+	{
+		//If it's a selection port of a cell
+		if( !consumer.node->isModulePlaceholder() && consumer.role == CellRepository::SELECTION_INPUT_ROLE )
+		{
+			toCorrect = true;
+			break;
+		}
+	}
+
+	return toCorrect;
+}
+
+void DFS::DFS::DFS_Data( Graph_Node::Node *currentNode, bool &data )
+{
+	data = data || this->engine.reachesEmitter(currentNode);
+}
+
+void DFS::DFS::DFS_Select( Graph_Node::Node *currentNode, bool &select )
+{
+	select = select || this->engine.reachesSelection(currentNode, this->deepScanEnabled);
+}
+
+std::pair<bool, bool> DFS::DFS::DFS_DeepScan( Graph_Node::Node *analyzedNode,Graph_Port::Port *analyzedPort )
+{
+    std::pair<bool,bool> result = std::make_pair(false, false);
+
+    if(this->summaries == nullptr)
+    {
+        return result;
+    }
+
+    int moduleIndex = this->summaries->findModuleIndex(analyzedNode->getType());
+
+    if(moduleIndex < 0)
+    {
+        return result;
+    }
+
+    //The inner module is analyzed only if nobody did it before in this run, its summary is then shared with everyone
+    if(!this->summaries->isSummarized(moduleIndex))
+    {
+        Generator::Generator *analyzedNodeModule = this->summaries->getModule(moduleIndex);
+
+        if(analyzedNodeModule == nullptr)
         {
-            break;
+            return result;
         }
+
+        DFS dfs(analyzedNodeModule, this->summaries);
+        dfs.enableDeepScan();
+        if(!this->componentReachabilityEnabled)
+            dfs.disableComponentReachability();
+        if(this->laneSweepEnabled)
+            dfs.enableLaneSweep();
+        //Here we are performing the DFS on the inner node, performing the deepscan indeed
+        std::vector< std::pair<Signal::Signal, std::pair<bool, bool>>> res = dfs.DFS_FTSA(false);
+        this->summaries->publish(moduleIndex, std::move(res), analyzedNodeModule->getSliceStructure());
     }
-        
+
+    //Here we look up the role of the current port among the results of the inner module
+    int role = this->summaries->getPortRole(moduleIndex, Signal::findName(analyzedPort->getPortName()));
+
+    result.first = (role & ModuleSummary::DATA_ROLE) != 0;
+    result.second = (role & ModuleSummary::SELECT_ROLE) != 0;
+
     return result; 
 }
 
@@ -243,10 +583,10 @@ void DFS::DFS::TEST_DFS_SignalAnalyzer()
 	}
 }
 
-DFS::DFS::DFS( Generator::Generator *currentModule, std::vector<Generator::Generator *> designModules, bool deepScanEnabled )
+DFS::DFS::DFS( Generator::Generator *currentModule, ModuleSummary::ModuleSummaryStore *summaries, bool deepScanEnabled ) : engine(currentModule->getSupportGraph())
 {
     this->currentModule = currentModule;
-    this->designModules = designModules;
+    this->summaries = summaries;
     if(deepScanEnabled)
         this->enableDeepScan();
     else
@@ -254,7 +594,15 @@ DFS::DFS::DFS( Generator::Generator *currentModule, std::vector<Generator::Gener
 }
 
 Generator::Generator* DFS::DFS::getCurrentModule() {return this->currentModule; }
-std::vector<Generator::Generator *> DFS::DFS::getDesignModules() {return this->designModules; }
+std::vector<Generator::Generator *> DFS::DFS::getDesignModules()
+{
+    if(this->summaries == nullptr)
+    {
+        return std::vector<Generator::Generator *>();
+    }
+
+    return this->summaries->getModules();
+}
 
 bool DFS::DFS::isDeepScanEnabled() {return this->deepScanEnabled; }
 
@@ -262,7 +610,7 @@ bool DFS::DFS::enableDeepScan()
 {
     this->deepScanEnabled = false;
     
-    if(this->designModules.size() > 0)
+    if(this->summaries != nullptr && this->summaries->getModules().size() > 0)
     {
         this->deepScanEnabled = true;
     }
@@ -277,34 +625,27 @@ bool DFS::DFS::disableDeepScan()
     return deepScanEnabled;
 }
 
-void DFS::DFS::setPreviouslyProcessedModules(std::vector<DFSDSS *> previouslyProcessedModules)
-{
-    this->previouslyProcessedModules = previouslyProcessedModules;
-}
+void DFS::DFS::enableComponentReachability() { this->componentReachabilityEnabled = true; }
+void DFS::DFS::disableComponentReachability() { this->componentReachabilityEnabled = false; }
+bool DFS::DFS::isComponentReachabilityEnabled() { return this->componentReachabilityEnabled; }
 
-std::pair<bool, bool> DFS::DFS::DFS_SignalAnalyzer( Signal::Signal signal, bool verbose )
-{
-	std::stringstream ss;
-	// <Data, Select>
-	std::pair<bool, bool> signalPair = std::make_pair(false, false);
+void DFS::DFS::enableLaneSweep() { this->laneSweepEnabled = true; }
+void DFS::DFS::disableLaneSweep() { this->laneSweepEnabled = false; }
+bool DFS::DFS::isLaneSweepEnabled() { return this->laneSweepEnabled; }
 
+void DFS::DFS::enablePruning() { this->pruningEnabled = true; }
+void DFS::DFS::disablePruning() { this->pruningEnabled = false; }
+bool DFS::DFS::isPruningEnabled() { return this->pruningEnabled; }
+const SupportGraph::PruneStats &DFS::DFS::getPruneStats() { return this->pruneStats; }
 
-	if( !this->currentModule->isExternalSignal_byNameOnly(signal) )
-	{
-		if(verbose)
-		{
-			ss << "\tcannot procede DFS_Launcher because it's not an external signal.\n";
-			std::cout << ss.str() << std::endl;
-		}
+DFS::SignalSeeds DFS::DFS::DFS_SignalSeeds( Signal::Signal signal )
+{
+	SignalSeeds seeds;
 
-		return signalPair;
-	}
-	
 	bool entered = false;
 	for( auto node : this->currentModule->startingNodes_fullSignal(signal, true) )
 	{
         entered = true;
-        std::pair<bool, bool> res = std::make_pair(false, false);
         
         bool dataPort = false;
         
@@ -315,9 +656,9 @@ std::pair<bool, bool> DFS::DFS::DFS_SignalAnalyzer( Signal::Signal signal, bool
            {
                for(auto inputSig : sp->getInputSignals())
                {
-                   if(inputSig.getSignalName() == signal.getSignalName())
+                   if(inputSig.getSignalId() == signal.getSignalId())
                    {
-                       res.second = true;
+                       seeds.fixed.second = true;
                    }
                }
            }
@@ -327,35 +668,27 @@ std::pair<bool, bool> DFS::DFS::DFS_SignalAnalyzer( Signal::Signal signal, bool
            {
                for(auto inputSig : dp->getInputSignals())
                {
-                   if(inputSig.getSignalName() == signal.getSignalName())
+                   if(inputSig.getSignalId() == signal.getSignalId())
                     {
                         dataPort = true;
                     }
                }
            }
            
-           //Il segnale non viene mai usato come data, posso affermare che non è un segnale dati per questo nodo
-           if(!dataPort)
+           //Il segnale non viene mai usato come data, posso affermare che non è un segnale dati per questo nodo.
+           //Se viene usato come data , vado a verificare lungo il path se entra in qualche output
+           if(dataPort)
            {
-                std::pair<bool, bool> ress = DFS_NodeAnalyzer(node);
-                res.first = false;
-                res.second = res.second || ress.second;
-           }
-            //Se viene usato come data , vado a verificare lungo il path se entra in qualche output
-           else
-           {
-               std::pair<bool, bool> ress = DFS_NodeAnalyzer(node);
-                res.first = ress.first;
-                res.second = res.second || ress.second;
+               seeds.dataSeeds.push_back(node);
            }
+
+           seeds.selectSeeds.push_back(node);
         }
         else
         {
-            res = DFS_NodeAnalyzer(node);
+            seeds.dataSeeds.push_back(node);
+            seeds.selectSeeds.push_back(node);
         }
-        
-        signalPair.first = signalPair.first || res.first;
-        signalPair.second = signalPair.second || res.second;     
 	}
 
     //Here I check if the input signal directly goes into a selection input without exiting
@@ -363,12 +696,45 @@ std::pair<bool, bool> DFS::DFS::DFS_SignalAnalyzer( Signal::Signal signal, bool
     {
         if(this->currentModule->startingNodes_fullSignal(signal, false).size() > 0)
         {
-            signalPair.first = false;
-            signalPair.second = true;
+            seeds.fixed.second = true;
         }
     }
 	
-	signalPair.second = signalPair.second || DFS_MooreCorrection(signal);
+	seeds.fixed.second = seeds.fixed.second || DFS_MooreCorrection(signal);
+
+	return seeds;
+}
+
+std::pair<bool, bool> DFS::DFS::DFS_SignalAnalyzer( Signal::Signal signal, bool verbose )
+{
+	std::stringstream ss;
+	// <Data, Select>
+	std::pair<bool, bool> signalPair = std::make_pair(false, false);
+
+
+	if( !this->currentModule->isExternalSignal_byNameOnly(signal) )
+	{
+		if(verbose)
+		{
+			ss << "\tcannot procede DFS_Launcher because it's not an external signal.\n";
+			std::cout << ss.str() << std::endl;
+		}
+
+		return signalPair;
+	}
+
+	SignalSeeds seeds = DFS_SignalSeeds(signal);
+	signalPair = seeds.fixed;
+
+	for( auto node : seeds.dataSeeds )
+	{
+		DFS_Data( node, signalPair.first );
+	}
+
+	for( auto node : seeds.selectSeeds )
+	{
+		DFS_Select( node, signalPair.second );
+	}
 
 	if(verbose)
 	{
@@ -384,30 +750,15 @@ std::pair<bool, bool> DFS::DFS::DFS_NodeAnalyzer( Graph_Node::Node *currentNode,
 	std::stringstream ss;
 	bool select = false;
 	bool data = false;
-    
-    std::vector<Graph_Node::Node *> nodes = currentModule->getSupportGraph().getNodes();
 
 	if(verbose)
 	{
 		ss << "============ DFS Launched from " << currentNode->getName();
 	}
 
-	//Boolean vector, each one represents a node, needed for the DFS
-	std::vector<bool> visited;
-	for(int i=0; i< (int) nodes.size(); i++)
-	{
-		visited.push_back(false);
-	}
-	
-	DFS_Select( currentNode, visited, select);
-
-	visited.clear();
-	for(int i=0; i< (int) nodes.size(); i++)
-	{
-		visited.push_back(false);
-	}
+	DFS_Select( currentNode, select );
 
-	DFS_Data( currentNode, visited, data );
+	DFS_Data( currentNode, data );
 
 	if(verbose)
 	{
@@ -428,7 +779,19 @@ std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > DFS::DFS::DFS_
 {
 	std::stringstream ss;
 	std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > temp;
-    std::vector< std::pair< Signal::Signal, std::vector<char> > > sliceStructure = this->currentModule->getSliceStructure();
+    //The planes of the module are marked in place
+    SlicePlanes::SliceStructure &sliceStructure = this->currentModule->getSliceStructure();
+
+    /*
+     *  First pass: the slices to analyze and, for each of them, its seeds and the terms that need no traversal.
+     *  One slice is one lane of the propagation.
+     */
+    std::vector<int> laneSupport;
+    std::vector<Signal::Signal> laneSlice;
+    std::vector<Signal::Signal> laneSignal;
+    std::vector< std::pair<bool, bool> > laneResult;
+    std::vector< std::vector<Graph_Node::Node *> > dataSeeds;
+    std::vector< std::vector<Graph_Node::Node *> > selectSeeds;
 	
     //Foreach entering signal
 	for( auto enteringSignal : this->currentModule->getEnteringSignals() )
@@ -438,7 +801,7 @@ std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > DFS::DFS::DFS_
         //Find the correct index for the sliceSupport vector.
 		for( int i=0; i<(int)sliceStructure.size(); i++ )
 		{
-			if( sliceStructure[i].first.getSignalName() == enteringSignal.getSignalName() )
+			if( sliceStructure[i].first.getSignalId() == enteringSignal.getSignalId() )
 			{
 				supportIndex = i;
             }
@@ -449,66 +812,117 @@ std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > DFS::DFS::DFS_
 		//Search for all slices of that signal and keep the original one
 		for( auto signal : /*findSignalFriends(enteringSignal, true)*/ toAnalyze )
 		{
-            std::pair<bool, bool> data_select;
+            std::pair<bool, bool> data_select = std::make_pair(false, false);
+            SignalSeeds seeds;
             bool directOut = false;
             
             //Here we are checking if a signal is directly connected to the output
-            for(auto couple : currentModule->getCoupledSignals())
+            if(currentModule->isCoupledSignal_byNameOnly(signal))
             {
-                if(signal.getSignalName().compare(couple.first) == 0)
-                {
-                    directOut = true;
-                }
+                directOut = true;
+            }
+
+            Signal::Signal analyzed = directOut ? enteringSignal : signal;
+
+            if(this->currentModule->isExternalSignal_byNameOnly(analyzed))
+            {
+                seeds = DFS_SignalSeeds(analyzed);
+                data_select = seeds.fixed;
             }
             
             //If the signal is directly connected with the output we can say for sure that it is a data signal, we have to check only
             //the selection case
             if(directOut)
             {
-                data_select = DFS_SignalAnalyzer(enteringSignal);
                 data_select.first = true;
+                seeds.dataSeeds.clear();
             }
             else
             {
-                data_select = DFS_SignalAnalyzer(signal);
-                
                 //Here I check if the signal is directly connected to an InOut port of the module , if so it's a data input
-                    for(auto node : this->currentModule->getSupportGraph().getNodes())
-                    {
-                        for(auto inputPort : node->getInputs())
-                        {
-                            if(inputPort->isInOutPort())
-                            {
-                                for(auto sig : inputPort->getSignals())
-                                {
-                                    if(sig.getSignalName() == signal.getSignalName())
-                                    {
-                                        data_select.first = true;
-                                    }
-                                }
-                            }
-                        }
-                    }
+                if(this->currentModule->isInOutSignal_byNameOnly(signal))
+                {
+                    data_select.first = true;
+                }
             }
 
-			//Remainder : std::vector< std::pair< Signal::Signal, std::vector<char> > > sliceStructure;
-			for(int j=signal.getLSB(); j<signal.getMSB()+1; j++ )
-			{
-				if( j < (int)sliceStructure[supportIndex].second.size() )
-				sliceStructure[supportIndex].second[j] = Generator::nextLetter( sliceStructure[supportIndex].second[j], data_select );
-			}
-			
-			if(directOut)
+            laneSupport.push_back(supportIndex);
+            laneSlice.push_back(signal);
+            laneSignal.push_back(analyzed);
+            laneResult.push_back(data_select);
+            dataSeeds.push_back(seeds.dataSeeds);
+            selectSeeds.push_back(seeds.selectSeeds);
+		}
+	}
+
+    //Only the cones of the seeds matter from here on: the rest of the graph is dropped before the traversals
+    this->pruneStats = SupportGraph::PruneStats();
+    if(this->pruningEnabled)
+    {
+        std::vector<int> seedIds;
+
+        for(size_t lane = 0; lane < laneResult.size(); lane++)
+        {
+            for(auto node : dataSeeds[lane])
             {
-                temp.push_back( std::make_pair( enteringSignal, data_select ) );
+                seedIds.push_back(node->getId());
             }
-            else
+
+            for(auto node : selectSeeds[lane])
             {
-                temp.push_back( std::make_pair( signal, data_select ) );
+                seedIds.push_back(node->getId());
             }
+        }
 
-			
-		}
+        this->pruneStats = this->engine.pruneCones(seedIds, this->deepScanEnabled);
+    }
+
+    //Second pass: the traversal part of every lane, from the bit-parallel sweep of all the lanes together or from each starting node
+    if(this->laneSweepEnabled)
+    {
+        std::vector<char> dataLanes;
+        std::vector<char> selectLanes;
+
+        this->engine.propagateLanes(dataSeeds, selectSeeds, this->deepScanEnabled, dataLanes, selectLanes);
+
+        for(size_t lane = 0; lane < laneResult.size(); lane++)
+        {
+            laneResult[lane].first = laneResult[lane].first || dataLanes[lane];
+            laneResult[lane].second = laneResult[lane].second || selectLanes[lane];
+        }
+    }
+    else
+    {
+        //Every starting node of every signal and slice is answered from the same summary, instead of exploring its cone again
+        if(this->componentReachabilityEnabled)
+        {
+            this->engine.summarizeComponents(this->deepScanEnabled);
+        }
+
+        for(size_t lane = 0; lane < laneResult.size(); lane++)
+        {
+            for(auto node : dataSeeds[lane])
+            {
+                DFS_Data(node, laneResult[lane].first);
+            }
+
+            for(auto node : selectSeeds[lane])
+            {
+                DFS_Select(node, laneResult[lane].second);
+            }
+        }
+    }
+
+    //Last pass: the bits of each slice take its result, in the same order as the analysis
+    for(size_t lane = 0; lane < laneResult.size(); lane++)
+    {
+        Signal::Signal signal = laneSlice[lane];
+        int supportIndex = laneSupport[lane];
+
+            //Word ORs on the two planes of the signal, bits past its width are left out
+            sliceStructure[supportIndex].second.mark(signal.getLSB(), signal.getMSB(), laneResult[lane]);
+
+            temp.push_back( std::make_pair( laneSignal[lane], laneResult[lane] ) );
 	}
 
 	if(verbose)
@@ -521,7 +935,6 @@ std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > DFS::DFS::DFS_
 
 		std::cout << ss.str() << std::endl;
 	}
-    
-    this->currentModule->setSliceStructure(sliceStructure);
+
 	return temp;
 }
@@ -24,6 +24,7 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <cstdint>
 
 //Yosys libraries
 #include "kernel/yosys.h"
@@ -33,38 +34,133 @@
 #include "stdvector_support.h"
 #include "stdstring_support.h"
 #include "supportGraph.h"
+#include "frozenGraph.h"
 #include "module_to_graph.h"
 #include "cellrepo.h"
 #include "generator_library.h"
+#include "module_summary.h"
 
 USING_YOSYS_NAMESPACE
 
 namespace DFS
 {
     /*
-     *  Depth First Search Deep Scan Support
+     *  Starting points of the analysis of one signal, split from the traversals so that many signals can be resolved together.
+     *  dataSeeds/selectSeeds are the nodes whose data/select check decides the result, fixed holds the terms that need no traversal.
      */
-    class DFSDSS
+    struct SignalSeeds
+    {
+        std::vector<Graph_Node::Node *> dataSeeds;
+        std::vector<Graph_Node::Node *> selectSeeds;
+        //<Data, Select>
+        std::pair<bool, bool> fixed = std::make_pair(false, false);
+    };
+
+    /*
+     *  Depth First Search Engine. Iterative traversals over the frozen copy of the support graph of a single module, with an explicit work stack
+     *  and a visited vector that is never cleared: each traversal bumps the epoch and a node counts as visited only if it carries the current one.
+     *  Nothing is allocated per hop, so deep pipelines neither overflow the call stack nor copy the visited vector at each level.
+     */
+    class DFSEngine
     {
         private:
-            //Reference of the analyzed node
-            Generator::Generator *targetModule = nullptr;
-            //List of results obtained in previous calls of the deepscan
-            std::vector< std::pair<Signal::Signal, std::pair<bool, bool>>> previouslyProcessedResults;
-        
+            //Structure-of-arrays copy of the graph of the module, taken when the engine is built
+            SupportGraph::FrozenGraph graph;
+            //Epoch stamp of each node, indexed by node id
+            std::vector<unsigned int> visitStamp;
+            //Epoch of the running traversal
+            unsigned int visitEpoch = 0;
+            //Ids of the nodes still to be expanded
+            std::vector<int> workStack;
+
+            /*
+             *  Component summary: once the graph has been condensed in strongly connected components, dataReach[id] and selectReach[id]
+             *  answer the two checks for every node by lookup.
+             */
+            bool summarized = false;
+            bool summaryDeepScan = false;
+            std::vector<char> dataReach;
+            std::vector<char> selectReach;
+
+            /*
+             *  Start a new traversal from startId: older stamps become stale and the stack only holds startId.
+             */
+            void beginTraversal(int startId);
+
+            /*
+             *  Marks the node as visited in the running traversal. Returns false if it was already marked.
+             */
+            bool markVisited(int id);
+
+            /*
+             *  Is the successor followed by the data check (dataEdgesOnly) or by the select check?
+             */
+            bool follows(int successor, bool dataEdgesOnly);
+
+            /*
+             *  Does the successor enter a selection port? Ports of module placeholders count only with the deep scan.
+             */
+            bool entersSelection(int successor, bool deepScanEnabled);
+
+            /*
+             *  Iterative Tarjan over the edges selected by dataEdgesOnly. Components are closed in reverse topological order, so when one is closed
+             *  every component it reaches is final and reach[] can be filled in the same sweep: a node reaches the property if some node of its
+             *  component has it (nodeFlag) or some successor component reaches it.
+             */
+            void sweepComponents(bool dataEdgesOnly, const std::vector<char> &nodeFlag, std::vector<char> &reach);
+
+            /*
+             *  Per node properties checked by the two analyses: isEmitter[id] for the data check, entersSelection[id] if the node feeds a selection port.
+             */
+            void nodeFlags(bool deepScanEnabled, std::vector<char> &isEmitter, std::vector<char> &entersSelection);
+
+            /*
+             *  Bit-parallel propagation of one batch of at most LANE_BITS lanes: every node carries a mask with one bit per lane, seeds set their
+             *  lane bit and masks are OR-merged along the followed edges until nothing changes. Lane i is true if some node with nodeFlag ends up
+             *  with bit i set. Runs in O(E * LANE_WORDS) per sweep instead of one traversal per seed.
+             */
+            void propagateBatch(const std::vector< std::vector<Graph_Node::Node *> > &laneSeeds, size_t firstLane, size_t lanes, bool dataEdgesOnly,
+                                const std::vector<char> &nodeFlag, std::vector<char> &laneResult);
+
         public:
-            DFSDSS(Generator::Generator *targetModule);
-            
+            //Lanes carried by a single mask: 4 words, i.e. one AVX2 register
+            static const int LANE_WORDS = 4;
+            static const int LANE_BITS = 64 * LANE_WORDS;
+
+            /*
+             *  Freezes the graph: the module ports of its placeholders must already be set.
+             */
+            DFSEngine(SupportGraph::SupportGraph &sg);
+
+            /*
+             *  Data check: true if an emitter can be reached from startNode without entering selection ports.
+             */
+            bool reachesEmitter(Graph_Node::Node *startNode);
+
+            /*
+             *  Select check: true if a selection port can be reached from startNode. Ports of module placeholders count only with the deep scan.
+             */
+            bool reachesSelection(Graph_Node::Node *startNode, bool deepScanEnabled);
+
             /*
-             *  Method used for setting the results obtained by previous analysys
+             *  Condense the graph and compute both checks for all the nodes at once, in O(N+E). Afterwards the two methods above are lookups.
              */
-            void setPreviouslyProcessedResults(std::vector< std::pair<Signal::Signal, std::pair<bool, bool>>> previouslyProcessedResults);
+            void summarizeComponents(bool deepScanEnabled);
 
-            Generator::Generator *getTargetModule();
+            /*
+             *  Shrinks the frozen graph to the cones of the given seeds (see FrozenGraph::pruneCones). Must come before summarizeComponents and
+             *  propagateLanes; afterwards the checks are only meaningful from the seeds.
+             */
+            SupportGraph::PruneStats pruneCones(const std::vector<int> &seeds, bool deepScanEnabled);
 
-            std::vector< std::pair<Signal::Signal, std::pair<bool, bool>>> getPreviouslyProcessedResults();
+            /*
+             *  Multi-source version of the two checks: lane i is true if any node of dataSeeds[i] reaches an emitter (dataResult) and if any node
+             *  of selectSeeds[i] reaches a selection port (selectResult). Both planes are swept in batches of LANE_BITS lanes.
+             */
+            void propagateLanes(const std::vector< std::vector<Graph_Node::Node *> > &dataSeeds, const std::vector< std::vector<Graph_Node::Node *> > &selectSeeds,
+                                bool deepScanEnabled, std::vector<char> &dataResult, std::vector<char> &selectResult);
     };
-    
+
     /*
      *  Depth-First Search
      */
@@ -73,13 +169,22 @@ namespace DFS
         private:
             //Module where we have to start the DFS analisys
             Generator::Generator *currentModule = nullptr;
-            //All the modules of the design, used for performing the deepscan
-            std::vector<Generator::Generator *> designModules ;
-            CellRepository::CellRepository *cr = new CellRepository::CellRepository();
+            //Summaries of all the modules of the design, shared by the whole run and used for performing the deepscan
+            ModuleSummary::ModuleSummaryStore *summaries = nullptr;
+            CellRepository::CellRepository *cr = CellRepository::CellRepository::getInstance();
+            //Traversal engine bound to the support graph of currentModule
+            DFSEngine engine;
             //Boolean flag used to state if the deepscan (i.e. looking inside module cells) is enabled
             bool deepScanEnabled = false;
-            
-            std::vector<DFSDSS *>previouslyProcessedModules;
+            //Boolean flag used to state if DFS_FTSA answers the starting nodes from the component summary instead of traversing from each of them
+            bool componentReachabilityEnabled = true;
+            //Boolean flag used to state if DFS_FTSA resolves all the slices together with the bit-parallel lane propagation
+            bool laneSweepEnabled = false;
+            //Boolean flag used to state if DFS_FTSA prunes the graph to the cones of the entering signals before classifying them
+            bool pruningEnabled = true;
+            //Reduction obtained by the last DFS_FTSA
+            SupportGraph::PruneStats pruneStats;
+
 			
 			/*
 			 *	Method that covers the last possible selection case that the DFS could not cover due to forced discrimination. If the signal enters
@@ -89,15 +194,20 @@ namespace DFS
 			 */
 			bool DFS_MooreCorrection( Signal::Signal signal );
 
+			/*
+			 *	First half of DFS_SignalAnalyzer: starting nodes of the signal and the terms that are decided without exploring paths.
+			 */
+			SignalSeeds DFS_SignalSeeds( Signal::Signal signal );
+
 			/*
 			 *	Sub-method of DFS. It performs the checks to know whether a signal is a data signal. The result is stored inside bool& data.
 			 */
-			void DFS_Data( Graph_Node::Node *currentNode, std::vector<bool> visited, bool &data );
+			void DFS_Data( Graph_Node::Node *currentNode, bool &data );
 			
 			/*
 			 *	Sub-method of DFS. It performs the checks to know wheter a signal is a selector. The result is stored inside bool& select.
 			 */
-			void DFS_Select( Graph_Node::Node *currentNode, std::vector<bool> visited, bool &select );
+			void DFS_Select( Graph_Node::Node *currentNode, bool &select );
 			
 			/*
              *  Method used for looking inside inner modules in order to decide if a signal is used as DATA/SELECT inside inner modules.
@@ -112,7 +222,7 @@ namespace DFS
 			void TEST_DFS_SignalAnalyzer();
             
         public:
-            DFS( Generator::Generator *currentModule, std::vector<Generator::Generator *> designModules, bool deepScanEnabled = true );
+            DFS( Generator::Generator *currentModule, ModuleSummary::ModuleSummaryStore *summaries, bool deepScanEnabled = true );
             
             //Getters
             Generator::Generator *getCurrentModule();
@@ -124,7 +234,7 @@ namespace DFS
             /*
              * Method used for enabling the deepscan (i.e. looking inside inner modules in case of nested modules)
              * 
-             * deepscan can be enabled only if the design modules have been setted
+             * deepscan can be enabled only if a summary store with the design modules has been given
              */
             bool enableDeepScan();
             
@@ -133,12 +243,34 @@ namespace DFS
              * it is always possible to disable such operation
              */
             bool disableDeepScan();
-            
+
+            /*
+             * Method used for enabling/disabling the SCC-condensed reachability used by DFS_FTSA.
+             * Results are the same, disabling it traverses the graph from each starting node.
+             */
+            void enableComponentReachability();
+            void disableComponentReachability();
+            bool isComponentReachabilityEnabled();
+
+            /*
+             * Method used for enabling/disabling the bit-parallel lane propagation used by DFS_FTSA. Results are the same, enabling it
+             * resolves all the slices together in batches of LANE_BITS lanes and takes the place of the SCC-condensed reachability.
+             */
+            void enableLaneSweep();
+            void disableLaneSweep();
+            bool isLaneSweepEnabled();
+
+            /*
+             * Method used for enabling/disabling the cone-of-influence pruning done by DFS_FTSA. Results are the same.
+             */
+            void enablePruning();
+            void disablePruning();
+            bool isPruningEnabled();
+
             /*
-             * Method used for passing the previously processed signals in case of deep-scan search
-             * to further iteration DFS instances
+             * Size of the graph before and after the pruning of the last DFS_FTSA (all zero if it was disabled).
              */
-            void setPreviouslyProcessedModules(std::vector<DFSDSS *> previouslyProcessedModules);
+            const SupportGraph::PruneStats &getPruneStats();
             
             /*
 			 *	Given a single signal it returns the result of a DFS Select + Data analysis.
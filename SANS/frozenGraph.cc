@@ -0,0 +1,407 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Standard libraries
+#include <unordered_map>
+
+//Application libraries
+#include "frozenGraph.h"
+
+SupportGraph::FrozenGraph::FrozenGraph(SupportGraph &sg)
+{
+	const std::vector<Graph_Node::Node *> &nodes = sg.getNodes();
+	std::unordered_map<std::string, int> typeIds;
+
+	this->nodeIdBound = sg.getNodeIdBound();
+	this->nodeObjects.assign(this->nodeIdBound, nullptr);
+	this->nodeType.assign(this->nodeIdBound, -1);
+	this->nodeFlags.assign(this->nodeIdBound, 0);
+
+	for( auto node : nodes )
+	{
+		int id = node->getId();
+
+		//Same as the edge index: nodes without a valid id are not part of the traversals
+		if( id < 0 || this->nodeObjects[id] != nullptr )
+		{
+			continue;
+		}
+
+		this->nodeOrder.push_back(id);
+		this->nodeObjects[id] = node;
+
+		auto known = typeIds.find(node->getType());
+		if( known == typeIds.end() )
+		{
+			known = typeIds.insert(std::make_pair(node->getType(), (int)this->typeNames.size())).first;
+			this->typeNames.push_back(node->getType());
+		}
+		this->nodeType[id] = known->second;
+
+		unsigned char flags = NODE_PRESENT;
+		if( node->isEmitter() )
+		{
+			flags |= NODE_EMITTER;
+		}
+		if( node->isModulePlaceholder() )
+		{
+			flags |= NODE_PLACEHOLDER;
+		}
+		this->nodeFlags[id] = flags;
+	}
+
+	//Ports and their edges, node after node in id order
+	this->portOffsets.assign(this->nodeIdBound + 1, 0);
+	this->portEdgeOffsets.push_back(0);
+
+	for( int id=0; id<this->nodeIdBound; id++ )
+	{
+		if( this->nodeObjects[id] != nullptr )
+		{
+			for( auto port : this->nodeObjects[id]->getPorts() )
+			{
+				this->portDirection.push_back((unsigned char)(port->getPortDirection() + 1));
+
+				for( auto edge : port->getEdges() )
+				{
+					this->portEdges.push_back(edge);
+				}
+				this->portEdgeOffsets.push_back((int)this->portEdges.size());
+			}
+		}
+
+		this->portOffsets[id + 1] = (int)this->portDirection.size();
+	}
+
+	//Successors: the <node, port> pairs of the edge index are merged per target node, their roles become the flag bits
+	std::vector<int> slotOf(this->nodeIdBound, -1);
+	this->successorOffsets.assign(this->nodeIdBound + 1, 0);
+
+	for( int id=0; id<this->nodeIdBound; id++ )
+	{
+		Graph_Node::Node *node = this->nodeObjects[id];
+		int first = (int)this->successorNode.size();
+
+		if( node != nullptr )
+		{
+			for( const EdgeConsumer &next : sg.successorsOf(node) )
+			{
+				int target = next.node->getId();
+				unsigned char flags = 0;
+
+				if( target < 0 )
+				{
+					continue;
+				}
+
+				if( !sg.isSelectionConsumer(node, next) )
+				{
+					flags |= EDGE_DATA;
+				}
+
+				if( next.role == SELECTION_CONSUMER )
+				{
+					flags |= EDGE_SELECTION;
+				}
+				else if( next.role == PLACEHOLDER_CONSUMER && VectorSupport::isIn(next.node->getModuleSelectionPorts(), next.port) )
+				{
+					flags |= EDGE_MODULE_SELECTION;
+				}
+
+				//slotOf[target] is valid only if it points inside the successors of this node
+				if( slotOf[target] >= first )
+				{
+					this->successorFlags[ slotOf[target] ] |= flags;
+				}
+				else
+				{
+					slotOf[target] = (int)this->successorNode.size();
+					this->successorNode.push_back(target);
+					this->successorFlags.push_back(flags);
+				}
+			}
+		}
+
+		this->successorOffsets[id + 1] = (int)this->successorNode.size();
+	}
+}
+
+SupportGraph::PruneStats SupportGraph::FrozenGraph::pruneCones(const std::vector<int> &seeds, bool deepScanEnabled)
+{
+	int bound = this->nodeIdBound;
+	PruneStats stats;
+	std::vector<char> isSeed(bound, 0);
+	std::vector<char> reached(bound, 0);
+	std::vector<char> relevant(bound, 0);
+	std::vector<int> stack;
+
+	stats.nodesBefore = (int)this->nodeOrder.size();
+	stats.successorsBefore = (int)this->successorNode.size();
+
+	//Forward cone of the seeds
+	for( int seed : seeds )
+	{
+		if( seed >= 0 && seed < bound && (this->nodeFlags[seed] & NODE_PRESENT) && !isSeed[seed] )
+		{
+			isSeed[seed] = 1;
+			reached[seed] = 1;
+			stack.push_back(seed);
+		}
+	}
+
+	while( !stack.empty() )
+	{
+		int id = stack.back();
+		stack.pop_back();
+
+		for( int next = this->successorOffsets[id]; next < this->successorOffsets[id + 1]; next++ )
+		{
+			int nextId = this->successorNode[next];
+
+			if( !reached[nextId] )
+			{
+				reached[nextId] = 1;
+				stack.push_back(nextId);
+			}
+		}
+	}
+
+	//Backward cone of the emitters and of the nodes feeding a selection port, over the reached nodes only
+	std::vector<int> predecessorOffsets(bound + 1, 0);
+	std::vector<int> predecessorNode(this->successorNode.size());
+
+	for( int id : this->nodeOrder )
+	{
+		if( !reached[id] )
+		{
+			continue;
+		}
+
+		for( int next = this->successorOffsets[id]; next < this->successorOffsets[id + 1]; next++ )
+		{
+			predecessorOffsets[ this->successorNode[next] + 1 ]++;
+		}
+	}
+
+	for( int id = 0; id < bound; id++ )
+	{
+		predecessorOffsets[id + 1] += predecessorOffsets[id];
+	}
+
+	{
+		std::vector<int> cursor(predecessorOffsets.begin(), predecessorOffsets.end() - 1);
+
+		for( int id : this->nodeOrder )
+		{
+			if( !reached[id] )
+			{
+				continue;
+			}
+
+			bool feedsSelection = false;
+
+			for( int next = this->successorOffsets[id]; next < this->successorOffsets[id + 1]; next++ )
+			{
+				unsigned char flags = this->successorFlags[next];
+
+				predecessorNode[ cursor[ this->successorNode[next] ]++ ] = id;
+
+				if( (flags & EDGE_SELECTION) || (deepScanEnabled && (flags & EDGE_MODULE_SELECTION)) )
+				{
+					feedsSelection = true;
+				}
+			}
+
+			if( feedsSelection || (this->nodeFlags[id] & NODE_EMITTER) )
+			{
+				relevant[id] = 1;
+				stack.push_back(id);
+			}
+		}
+	}
+
+	while( !stack.empty() )
+	{
+		int id = stack.back();
+		stack.pop_back();
+
+		for( int prev = predecessorOffsets[id]; prev < predecessorOffsets[id + 1]; prev++ )
+		{
+			int prevId = predecessorNode[prev];
+
+			if( !relevant[prevId] )
+			{
+				relevant[prevId] = 1;
+				stack.push_back(prevId);
+			}
+		}
+	}
+
+	//Seeds always stay: the analysis asks for them by id
+	std::vector<char> kept(bound, 0);
+
+	for( int id : this->nodeOrder )
+	{
+		kept[id] = isSeed[id] || (reached[id] && relevant[id]);
+	}
+
+	//Selection ports are found on the edge, its target has to stay even if nothing follows it
+	for( int id : this->nodeOrder )
+	{
+		if( !kept[id] )
+		{
+			continue;
+		}
+
+		for( int next = this->successorOffsets[id]; next < this->successorOffsets[id + 1]; next++ )
+		{
+			unsigned char flags = this->successorFlags[next];
+
+			if( (flags & EDGE_SELECTION) || (deepScanEnabled && (flags & EDGE_MODULE_SELECTION)) )
+			{
+				kept[ this->successorNode[next] ] = 1;
+			}
+		}
+	}
+
+	/*
+	 *	A pass-through cell entered only through data ports is transparent for both checks: going through it is the same as following its
+	 *	successors straight away. It must not decide anything by itself, so emitters and placeholders stay.
+	 */
+	std::vector<char> passThroughType(this->typeNames.size(), 0);
+
+	for( size_t t = 0; t < this->typeNames.size(); t++ )
+	{
+		const std::string &type = this->typeNames[t];
+		passThroughType[t] = type == "$pos" || type == "$slice" || type == "$concat";
+	}
+
+	std::vector<char> collapsed(bound, 0);
+
+	for( int id : this->nodeOrder )
+	{
+		collapsed[id] = kept[id] && !isSeed[id] && passThroughType[ this->nodeType[id] ] && !(this->nodeFlags[id] & (NODE_EMITTER | NODE_PLACEHOLDER));
+	}
+
+	for( int id : this->nodeOrder )
+	{
+		if( !kept[id] )
+		{
+			continue;
+		}
+
+		for( int next = this->successorOffsets[id]; next < this->successorOffsets[id + 1]; next++ )
+		{
+			if( this->successorFlags[next] != EDGE_DATA )
+			{
+				collapsed[ this->successorNode[next] ] = 0;
+			}
+		}
+	}
+
+	//New successors: edges into collapsed cells are replaced by the edges out of them, chains included
+	std::vector<int> offsets(bound + 1, 0);
+	std::vector<int> targets;
+	std::vector<unsigned char> flags;
+	std::vector<int> slotOf(bound, -1);
+	std::vector<int> expandedBy(bound, -1);
+
+	for( int id = 0; id < bound; id++ )
+	{
+		int first = (int)targets.size();
+
+		if( kept[id] && !collapsed[id] )
+		{
+			stack.clear();
+			stack.push_back(id);
+			expandedBy[id] = id;
+
+			while( !stack.empty() )
+			{
+				int source = stack.back();
+				stack.pop_back();
+
+				for( int next = this->successorOffsets[source]; next < this->successorOffsets[source + 1]; next++ )
+				{
+					int target = this->successorNode[next];
+
+					if( !kept[target] || target == id )
+					{
+						continue;
+					}
+
+					if( collapsed[target] )
+					{
+						if( expandedBy[target] != id )
+						{
+							expandedBy[target] = id;
+							stack.push_back(target);
+						}
+
+						continue;
+					}
+
+					if( slotOf[target] >= first )
+					{
+						flags[ slotOf[target] ] |= this->successorFlags[next];
+					}
+					else
+					{
+						slotOf[target] = (int)targets.size();
+						targets.push_back(target);
+						flags.push_back(this->successorFlags[next]);
+					}
+				}
+			}
+		}
+
+		offsets[id + 1] = (int)targets.size();
+
+		if( !kept[id] || collapsed[id] )
+		{
+			if( collapsed[id] )
+			{
+				stats.collapsed++;
+			}
+
+			this->nodeFlags[id] = 0;
+		}
+	}
+
+	//Ids keep their place in getNodeOrder, only the survivors are left
+	std::vector<int> survivors;
+
+	for( int id : this->nodeOrder )
+	{
+		if( kept[id] && !collapsed[id] )
+		{
+			survivors.push_back(id);
+		}
+	}
+
+	this->nodeOrder.swap(survivors);
+	this->successorOffsets.swap(offsets);
+	this->successorNode.swap(targets);
+	this->successorFlags.swap(flags);
+
+	stats.nodesAfter = (int)this->nodeOrder.size();
+	stats.successorsAfter = (int)this->successorNode.size();
+
+	return stats;
+}
@@ -0,0 +1,142 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef FROZEN_GRAPH_H
+#define FROZEN_GRAPH_H
+
+//Standard libraries
+#include <string>
+#include <vector>
+
+//Application libraries
+#include "supportGraph.h"
+
+namespace SupportGraph
+{
+	/*
+	 *	Bits of FrozenGraph::getNodeFlags.
+	 */
+	enum FrozenNodeFlag
+	{
+		//Some node of the graph carries this id
+		NODE_PRESENT = 1,
+		//At least one output of the node is connected to extern (see Graph_Node::Node::isEmitter)
+		NODE_EMITTER = 2,
+		//The node is a module placeholder
+		NODE_PLACEHOLDER = 4
+	};
+
+	/*
+	 *	Bits of FrozenGraph::getSuccessorFlags. A successor stands for all the ports of the target node reached by the source, so the bits are
+	 *	the union over those ports.
+	 */
+	enum FrozenEdgeFlag
+	{
+		//Some reached port lets the data check through (see SupportGraph::isSelectionConsumer)
+		EDGE_DATA = 1,
+		//Some reached port is a selection input of a cell
+		EDGE_SELECTION = 2,
+		//Some reached port is a selection port of a module placeholder, it counts only with the deep scan
+		EDGE_MODULE_SELECTION = 4
+	};
+
+	/*
+	 *	Size of a FrozenGraph before and after FrozenGraph::pruneCones.
+	 */
+	struct PruneStats
+	{
+		int nodesBefore = 0;
+		int nodesAfter = 0;
+		int successorsBefore = 0;
+		int successorsAfter = 0;
+		//Pass-through cells removed by shortcutting their predecessors to their successors
+		int collapsed = 0;
+	};
+
+	/*
+	 *	Read-only structure-of-arrays copy of a complete SupportGraph, meant for the analysis phase. Everything is addressed by node id and lives
+	 *	in flat vectors: node types and flags, the ports of each node (CSR over portDirection/portEdges) and the successors of each node (CSR over
+	 *	successorNode/successorFlags). Traversals only touch integers and bytes instead of chasing Node and Port objects across the heap.
+	 *	The copy does not follow later changes of the graph: freeze it once the module ports of the placeholders are set.
+	 */
+	class FrozenGraph
+	{
+		private:
+			//Greatest node id plus one
+			int nodeIdBound = 0;
+			//Node ids in the order of SupportGraph::getNodes
+			std::vector<int> nodeOrder;
+			//Source object of each id, nullptr for missing ids
+			std::vector<Graph_Node::Node *> nodeObjects;
+			//Type of each node, as an index in typeNames
+			std::vector<int> nodeType;
+			std::vector<std::string> typeNames;
+			//FrozenNodeFlag bits of each node
+			std::vector<unsigned char> nodeFlags;
+
+			//Ports of node n: [ portOffsets[n], portOffsets[n+1] ), in the order of Graph_Node::Node::getPorts
+			std::vector<int> portOffsets;
+			std::vector<unsigned char> portDirection;
+			//Edges of port p: portEdges[ portEdgeOffsets[p] .. portEdgeOffsets[p+1] )
+			std::vector<int> portEdgeOffsets;
+			std::vector<int> portEdges;
+
+			//Successors of node n: [ successorOffsets[n], successorOffsets[n+1] ), each target once and the node itself excluded
+			std::vector<int> successorOffsets;
+			std::vector<int> successorNode;
+			std::vector<unsigned char> successorFlags;
+
+		public:
+			/*
+			 *	Builds the arrays from the object graph, in O(N + P + E).
+			 */
+			FrozenGraph(SupportGraph &sg);
+
+			/*
+			 *	Cone-of-influence reduction, for an analysis that only starts from the seeds. Drops the nodes no seed can reach and the ones that
+			 *	reach neither an emitter nor a selection port (module selection ports count only with the deep scan), then collapses the
+			 *	$pos/$slice/$concat cells that are entered only through data ports: their predecessors get their successors instead. The two checks
+			 *	give the same answers from every seed, while any other node may be gone. Successors are merged as in the constructor.
+			 */
+			PruneStats pruneCones(const std::vector<int> &seeds, bool deepScanEnabled);
+
+			int getNodeIdBound() const { return this->nodeIdBound; }
+			int getSuccessorCount() const { return (int)this->successorNode.size(); }
+			const std::vector<int> &getNodeOrder() const { return this->nodeOrder; }
+			Graph_Node::Node *getNode(int id) const { return this->nodeObjects[id]; }
+
+			int getNodeType(int id) const { return this->nodeType[id]; }
+			const std::string &getTypeName(int typeId) const { return this->typeNames[typeId]; }
+			unsigned char getNodeFlags(int id) const { return this->nodeFlags[id]; }
+			bool isEmitter(int id) const { return (this->nodeFlags[id] & NODE_EMITTER) != 0; }
+
+			int portsBegin(int id) const { return this->portOffsets[id]; }
+			int portsEnd(int id) const { return this->portOffsets[id + 1]; }
+			Graph_Port::PortDirection getPortDirection(int port) const { return (Graph_Port::PortDirection)((int)this->portDirection[port] - 1); }
+			const int *portEdgesBegin(int port) const { return this->portEdges.data() + this->portEdgeOffsets[port]; }
+			const int *portEdgesEnd(int port) const { return this->portEdges.data() + this->portEdgeOffsets[port + 1]; }
+
+			int successorsBegin(int id) const { return this->successorOffsets[id]; }
+			int successorsEnd(int id) const { return this->successorOffsets[id + 1]; }
+			int getSuccessorNode(int successor) const { return this->successorNode[successor]; }
+			unsigned char getSuccessorFlags(int successor) const { return this->successorFlags[successor]; }
+	};
+}
+
+#endif
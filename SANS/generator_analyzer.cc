@@ -86,7 +86,7 @@ USING_YOSYS_NAMESPACE
 			{
 				std::stringstream ss = this->getHeader(wrappedModule, "TEST_allNextNodes");
                 
-                SupportGraph::SupportGraph sg = wrappedModule->getSupportGraph();
+                SupportGraph::SupportGraph &sg = wrappedModule->getSupportGraph();
 
 				for( auto node : sg.getNodes() )
 				{
@@ -192,7 +192,7 @@ USING_YOSYS_NAMESPACE
 			{
 				std::stringstream ss = this->getHeader(wrappedModule, "TEST_node_classification");
                 
-                SupportGraph::SupportGraph sg = wrappedModule->getSupportGraph();
+                SupportGraph::SupportGraph &sg = wrappedModule->getSupportGraph();
 
 				for( auto node : sg.getNodes() )
 				{
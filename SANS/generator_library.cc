@@ -24,70 +24,12 @@
 #include "stdstring_support.h"
 #include "module_to_graph.h"
 #include "rtlil_dumper.h"
+#include "thread_pool.h"
+#include "profiler.h"
 #include "generator_library.h"
 
 USING_YOSYS_NAMESPACE
 
-/*
- *	Decides what letter the support structure shall contain for each bit of each signal.
- *	NB: downgrades are not feasible. A signal which has been recognized as SELECT somewhere will forever remain at least a SELECT signal, that's
- *	why there are some 'return currentCode'.
- */
-char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select )
-{
-	switch(currentCode)
-	{
-		case NONE:
-			if( data_select.first && data_select.second)
-			{
-				return BOTH;
-			}
-			else if(data_select.first)
-			{
-				return DATA;
-			}
-			else if(data_select.second)
-			{
-				return SELECT;
-			}
-			else
-			{
-				return NONE;
-			}
-		break;
-
-		case SELECT:
-			if(data_select.first)
-			{
-				return BOTH;
-			}
-			else
-			{
-				return currentCode;
-			}
-		break;
-
-		case DATA:
-			if(data_select.second)
-			{
-				return BOTH;
-			}
-			else
-			{
-				return currentCode;
-			}
-		break;
-
-		case BOTH:
-			return currentCode;
-		break;
-
-		default:
-			std::cout <<"Unrecognized letter code in nextLetter :" << currentCode << "\n";
-			return ERROR_CODE;
-	}
-}
-
 		/*
 		 *	Removes unneded parts of a particular string (used in cleanseConnection)
 		 */
@@ -126,48 +68,49 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 				for( auto inputsignal : node->getInputSignals() )
 				{
 					//Returns oldName
-					std::string temp = getRenaming( inputsignal.getSignalName(), false );
+					int temp = getRenaming( inputsignal.getSignalId(), false );
 
-					Signal::Signal sig = fetchSignal(this->externalSignals, temp);
+					auto ext = (temp >= 0) ? externalByName.find(temp) : externalByName.end();
 					
-					if( !VectorSupport::isIn(enteringSignals, sig) && !temp.empty() && sig.getSignalName()!="Empty")
+					if( ext != externalByName.end() )
 					{
-						//std::cout << "ENTERING " << sig.toString() << "\n";
-						this->enteringSignals.push_back(sig);
+						//std::cout << "ENTERING " << ext->second.toString() << "\n";
+						addSignal(this->enteringSignals, this->enteringByName, ext->second);
 					}
 				}
 
 				for( auto outputsignal : node->getOutputSignals() )
 				{
 					//Returns newName
-					std::string temp = getRenaming( outputsignal.getSignalName(), true );
+					int temp = getRenaming( outputsignal.getSignalId(), true );
 
-					Signal::Signal sig = fetchSignal(this->externalSignals, temp);
+					auto ext = (temp >= 0) ? externalByName.find(temp) : externalByName.end();
 
-					if( !VectorSupport::isIn(exitingSignals, sig) && !temp.empty() && sig.getSignalName()!="Empty" )
+					if( ext != externalByName.end() )
 					{
-						//std::cout << "EXITING " << sig.toString() << "\n";
-						this->exitingSignals.push_back(sig);
+						//std::cout << "EXITING " << ext->second.toString() << "\n";
+						addSignal(this->exitingSignals, this->exitingByName, ext->second);
 					}
 				}
 			}
 
 			//std::cout << StringSupport::DUMP_vector(coupledSignals);
 
-			for( auto pair : this->coupledSignals )
+			//pairedSignals holds the same couples as coupledSignals, as signals
+			for( auto &pair : this->pairedSignals )
 			{
-				Signal::Signal newsig = Signal::fetchSignal(exitingSignals, pair.first);
-				Signal::Signal oldsig = Signal::fetchSignal(enteringSignals, pair.second);
+				bool newsigExiting = exitingByName.count(pair.first.getSignalId()) > 0;
+				bool oldsigEntering = enteringByName.count(pair.second.getSignalId()) > 0;
 
-				if( oldsig.getSignalName()=="Empty"	&& newsig.getSignalName()=="Empty" )
+				if( !oldsigEntering && !newsigExiting )
 				{
-					Signal::Signal oldsigExt = Signal::fetchSignal(externalSignals, pair.second);
-					Signal::Signal newsigExt = Signal::fetchSignal(externalSignals, pair.first);
+					auto oldsigExt = externalByName.find(pair.second.getSignalId());
+					auto newsigExt = externalByName.find(pair.first.getSignalId());
 
-					if( oldsigExt.getSignalName()!="Empty" && newsigExt.getSignalName()!="Empty" )
+					if( oldsigExt != externalByName.end() && newsigExt != externalByName.end() )
 					{
-						this->enteringSignals.push_back(oldsigExt);
-						this->exitingSignals.push_back(newsigExt);
+						addSignal(this->enteringSignals, this->enteringByName, oldsigExt->second);
+						addSignal(this->exitingSignals, this->exitingByName, newsigExt->second);
 					}
 				}
 			}
@@ -209,7 +152,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
         /*
          * Method used for extracting the connections between internal cells outputs and the module's outputs
          */
-        std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> Generator::Generator::extractModuleOutputBinding(RTLIL::Module *module)
+        std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> Generator::Generator::extractModuleOutputBinding(const ModToGraph::ModuleSnapshot &module)
         {
             std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> moduleOutputBindings ;
             std::vector<Signal::Signal> internalCellsOutputs; 
@@ -217,10 +160,9 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
             
             moduleOutputBindings = std::make_pair(internalCellsOutputs, moduleOutputs);
             
-            for(auto it = module->connections().begin(); it != module->connections().end(); it++)
+            for(auto &tmp : module.connections)
             {
-                //pair that contains all the signals associated to a module outputs and internal cells outputs connected to the module's ones
-                std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> tmp = RTLIL_DUMPER::connDumper(it->first, it->second);
+                //tmp contains all the signals associated to a module outputs and internal cells outputs connected to the module's ones
                 
                 //Signals associated to module's (internal) cells
                 for(auto internalCellOutput : tmp.first)
@@ -245,43 +187,44 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
          * (i.e. this method as to be called only in case of output/inout cells, NOT in case of input ones ,
          * since this method only exploits output connections between a cell and a module)
          */
-        void Generator::Generator::setCellOutputModuleOutputBindings(  RTLIL::Cell *cell, //RTLIL::Cell that we want to inspect
+        void Generator::Generator::setCellOutputModuleOutputBindings(  const std::vector<std::pair<bool, std::vector<Signal::Signal>>> &cellSignals, //Dumped connections of the RTLIL::Cell that we want to inspect
                                                  Graph_Port::Port *newPort, //Port that we have created for our purposes
-                                                 std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> moduleOutputBindings, //Binding of the module with the extern
+                                                 const dict<Signal::Signal, int> &moduleOutputs, //Module's outputs bound to internal cells, with their multiplicity
                                                  bool inout //Boolean flag used to decree if the port is an inout port (true -> inout port, false->output port)
                                                 )
         {
             //Here we are checking if the inout cell has some bindings with the current module's outputs
-            for(auto &it : cell->connections())
+            for(auto &tmp : cellSignals)
             {
-                //Extracting the connections of the cell
-                std::pair<bool, std::vector<Signal::Signal>> tmp = RTLIL_DUMPER::sigSpecDumper(it.second);
-                
                 //Looking if the connection extraction has been successfully performed
                 if(tmp.first)
                 {
                     //In case of successfull extraction, we cycle through the cell's signals
-                    for(auto sig : tmp.second)
+                    for(auto &sig : tmp.second)
                     {
-                        //Cycling throu the module output bindings                                
-                        for(auto mob : moduleOutputBindings.second)
+                        //Looking if the signal associated to the cell is the same as one coming out the module
+                        auto mob = moduleOutputs.find(sig);
+
+                        if(mob == moduleOutputs.end())
                         {
-                            //Looking if the signal associated to the cell is the same as the one coming out the module
-                            if(sig == mob)
+                            continue;
+                        }
+
+                        //The signal is bound once for each time it appears among the module's outputs
+                        for(int i = 0; i < mob->second; i++)
+                        {
+                            //Case of inout port
+                            if(inout)
                             {
-                                //Case of inout port
-                                if(inout)
-                                {
-                                   newPort->pushInOutSignal(sig);
-                                   newPort->setConnectionToExtern(true); 
-                                }
-                                //case of output port
-                                else
-                                {
-                                    newPort->pushOutputSignal(sig);
-                                    //newPort->setConnectionToExtern(true);
-                                }  
+                               newPort->pushInOutSignal(sig);
+                               newPort->setConnectionToExtern(true); 
                             }
+                            //case of output port
+                            else
+                            {
+                                newPort->pushOutputSignal(sig);
+                                //newPort->setConnectionToExtern(true);
+                            }  
                         }
                     }
                 }
@@ -292,23 +235,20 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
          * Method used for determine if a specific port is an InOut port and which signals 
          * are connected to that port in such case
          */
-        std::pair<bool, std::vector<Signal::Signal>> Generator::Generator::extractInoutPorts(RTLIL::SigSpec conn)
+        std::pair<bool, std::vector<Signal::Signal>> Generator::Generator::extractInoutPorts(const std::vector<Signal::Signal> &connSignals)
         {
             std::pair<bool, std::vector<Signal::Signal>> result;
             bool inoutPort = false;
             std::vector<Signal::Signal> signals;
-            
-            std::pair<bool, std::vector<Signal::Signal>> conny = RTLIL_DUMPER::sigSpecDumper(conn);
                                         
-            for(auto sig : conny.second)
-            {                        
-                for(auto exSig : inoutSignals)
+            for(auto &sig : connSignals)
+            {
+                auto exSig = inoutByName.find(sig.getSignalId());
+
+                if(exSig != inoutByName.end())
                 {
-                    if(sig.getSignalName().compare(exSig.getSignalName()) == 0)
-                    {
-                        inoutPort = true;
-                        signals.push_back(exSig);
-                	}
+                    inoutPort = true;
+                    signals.push_back(exSig->second);
                 }
             }
             
@@ -317,38 +257,41 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
             return result;
         }
 
+        void Generator::Generator::addSignal(std::vector<Signal::Signal> &signals, std::unordered_map<int, Signal::Signal> &byName, const Signal::Signal &signal)
+        {
+            if(byName.insert(std::make_pair(signal.getSignalId(), signal)).second)
+            {
+                signals.push_back(signal);
+            }
+        }
+
 
 		/*
 		 *	This method generates the final graph by taking the default subcircuit graph and the design.
 		 */
-		bool Generator::Generator::buildGraph(SubCircuit_v2::Graph& myg, RTLIL::Module *module)
+		bool Generator::Generator::buildGraph(SubCircuit_v2::Graph& myg, const ModToGraph::ModuleSnapshot &module)
 		{
-            this->moduleName = module->name.c_str();
+            this->moduleName = module.name;
 			std::vector< std::pair<std::string, std::string> > couples;
 
-			std::vector<std::string> design_modules;
-
-			//Extracting the names of the modules of our design
-			for(auto mod : module->design->modules())
-			{
-				design_modules.push_back(mod->name.str());
-			}
+			//Modules of our design instantiated here, indexed by name: a cell whose type is one of them is a module placeholder
+			const std::map< std::string, std::vector<ModToGraph::PortSnapshot> > &design_modules = module.instantiated;
 
 			//Evaluate the module for signal renaming
             /*
              * Here we are extraction the coupled signals of the module, i.e. the signals that 
              * are part of a connection for the module itself
              */
-            for(auto conn: module->connections())
+            for(auto &result : module.connections)
             {
-                std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> result = RTLIL_DUMPER::connDumper(conn.first, conn.second);
-                
                 for(auto fSig : result.first)
                 {
                     for(auto sSig : result.second)
                     {
                         coupledSignals.push_back(std::make_pair(fSig.getSignalName(), sSig.getSignalName()));
                         pairedSignals.push_back(std::make_pair(fSig, sSig));
+                        renamedTo.insert(std::make_pair(sSig.getSignalId(), fSig.getSignalId()));
+                        renamedFrom.insert(std::make_pair(fSig.getSignalId(), sSig.getSignalId()));
                     }
                 }
                 
@@ -356,338 +299,296 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
             }
             
             //Here we extract the memories of the module
-            std::vector<std::string> memories ;
-            for (auto it : module->memories)
-            {
-                //std::cout << "memory: " << it.second->name.c_str() << std::endl;
-                memories.push_back(it.second->name.c_str());
-            }
-            
+            const std::vector<std::string> &memories = module.memories;
 
-			for( auto spec : ModToGraph::mod2graph(myg, module) )
 			{
-				Signal::Signal temp ( spec.first, spec.second-1, 0 ); 
-				externalSignals = VectorSupport::conditionalInsert( externalSignals, temp );
+				Profiler::PhaseTimer timer(Profiler::PHASE_MOD2GRAPH);
+				ModToGraph::mod2graph(myg, module);
+			}
+
+			for( auto &wire : module.ports )
+			{
+				Signal::Signal temp ( wire.name, wire.width-1, 0 ); 
+				addSignal(externalSignals, externalByName, temp);
 
 				/*
 				 * Here we are discriminating the external signals of the module and collecting them 
                  * in their associated lists 
 				 */
-				for(auto wire : module->wires())
+                //case of inout signal
+				if((wire.input) && (wire.output))
 				{
-					if(wire->name.str().compare(temp.getSignalName()) == 0)
-					{
-                        //case of inout signal
-						if((wire->port_input) && (wire->port_output))
-						{
-							enteringSignals = conditionalInsert_checkSignalName(enteringSignals, temp);
-							exitingSignals = conditionalInsert_checkSignalName(exitingSignals, temp);
-                            inoutSignals = conditionalInsert_checkSignalName(inoutSignals, temp);
-						}
-						
-						//Case of input signal
-						if((wire->port_input) && (!wire->port_output))
-						{
-							enteringSignals = conditionalInsert_checkSignalName(enteringSignals, temp);
-						}
-
-						//Case of output signal
-						if((!wire->port_input) && (wire->port_output))
-						{
-							exitingSignals = conditionalInsert_checkSignalName(exitingSignals, temp);
-						}	
-						
-					}
+					addSignal(enteringSignals, enteringByName, temp);
+					addSignal(exitingSignals, exitingByName, temp);
+                    addSignal(inoutSignals, inoutByName, temp);
 				}
+				
+				//Case of input signal
+				if((wire.input) && (!wire.output))
+				{
+					addSignal(enteringSignals, enteringByName, temp);
+				}
+
+				//Case of output signal
+				if((!wire.input) && (wire.output))
+				{
+					addSignal(exitingSignals, exitingByName, temp);
+				}	
 			}
 			
 			/*
              * Extracting the bindings between internal components of a module and the output signals of
-             * the module itself
+             * the module itself. Only the module's side is needed here: it is counted by signal, so that a cell
+             * signal is bound once per occurrence without scanning the whole list.
              */
 			std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> moduleOutputBindings ;
             moduleOutputBindings = this->extractModuleOutputBinding(module);
 
+            dict<Signal::Signal, int> moduleOutputs;
+            for(auto &mob : moduleOutputBindings.second)
+            {
+                moduleOutputs[mob]++;
+            }
+
+			//Outcome of the memory check for each signal name met so far
+			dict<int, bool> memorySignals;
+
 			//Then, we run on all the nodes of the DESIGN (condensed in the graph)
-			for( auto subcircuitNode : ((Generator&)myg).nodes )
+			for( auto &subcircuitNode : ((Generator&)myg).nodes )
 			{
-				//Temporary variable to store the nodeId that we're going to find
-				int subCircuitId = -1;
-				//Count is used as a check, if we find more than one match, the id is not unique (and we have a problem)
-				int count = 0;
-				
-				for( auto nodeOfMap : ((Generator&)myg).nodeMap )
-				{	//subcircuitNode.nodeId is the future node name, this is unfortunate name overlapping
-					if( subcircuitNode.nodeId ==  nodeOfMap.first )
-					{
-						subCircuitId = nodeOfMap.second;
-						count++;
-					}
-				}
+				//subcircuitNode.nodeId is the future node name, this is unfortunate name overlapping
+				auto mapped = ((Generator&)myg).nodeMap.find(subcircuitNode.nodeId);
+				int subCircuitId = (mapped != ((Generator&)myg).nodeMap.end()) ? mapped->second : -1;
 
 				//Here we are checking if the cell is a module placeholder (i.e. a node that represents another module)
-				bool isModule = false;
-				for(auto mod : design_modules)
-				{
-					if(mod.compare(subcircuitNode.typeId) == 0) 
-					{
-						isModule = true;
-					}
-						
-				}
+				bool isModule = (design_modules.count(subcircuitNode.typeId) > 0);
 
 				//Just copy what we need from the existent graph.
-				Graph_Node::Node *newNode = new Graph_Node::Node(subCircuitId, subcircuitNode.nodeId, subcircuitNode.typeId, isModule);
+				Graph_Node::Node *newNode = sg.createNode(subCircuitId, subcircuitNode.nodeId, subcircuitNode.typeId, isModule);
+
+				//mod2graph keeps the cell behind every node, no need to join on the names
+				const ModToGraph::CellSnapshot *cell = (const ModToGraph::CellSnapshot *)subcircuitNode.userData;
+
+				if( cell != nullptr )
+				{
+					//The signals of each connection of the cell are dumped once, all its ports share them
+					std::vector< std::pair<bool, std::vector<Signal::Signal>> > cellSignals;
 
-					//Do NOT remove this.
-					SigMap sigmap(module);
+					//Here we check if the cell is connected to some of the module's memories
+					bool trovato = false;
 
-					for( auto cell : module->cells() )
+					for( auto &it : cell->connections )
 					{
-						//Join done.
-						if( subcircuitNode.nodeId == cell->name.str() )
+						cellSignals.push_back(it.signals);
+
+						for( auto &sig : cellSignals.back().second )
 						{
-							//Then, foreach port of said node, we extract the info needed.
-							for( auto subcircuitPort : subcircuitNode.ports )
+							if(memories.empty())
+							{
+								break;
+							}
+
+							auto known = memorySignals.find(sig.getSignalId());
+
+							if(known == memorySignals.end())
 							{
-								//We perform another join to match the port with its connection.
-								for( auto conn : cell->connections() )
+								bool found = false;
+
+								for(auto &memory : memories)
 								{
-									if( subcircuitPort.portId == conn.first.c_str() )
+									if(sig.getSignalName().find(memory) != std::string::npos)
 									{
-										/*	DO NOT DELETE THIS
-											std::cout << "NodeId " << subCircuitId << ", PortId " << subcircuitNode.portMap[subcircuitPort.portId] << "\n";
-											std::cout << "Node " << subcircuitNode.nodeId << ", PortName " << subcircuitPort.portId << "\n\n";
-										//*/
-                                            
-                                        std::pair<bool, std::vector<Signal::Signal>> inOut = this->extractInoutPorts(conn.second);
-                                        bool isInOut = inOut.first;
+										found = true;
+										break;
+									}
+								}
 
-										Graph_Port::Port *newPort = new Graph_Port::Port(subcircuitPort.portId, subcircuitNode.portMap[subcircuitPort.portId]);
-                                        
-                                        //Here we check if the cell is connected to some of the module's memories
-                                        bool trovato = false;
-                                        for (auto &it : cell->connections()) 
-                                        {
-                                               std::pair<bool, std::vector<Signal::Signal>> res = RTLIL_DUMPER::sigSpecDumper(it.second);
-                                               for(auto sig : res.second)
-                                               {
-                                                   for(auto memory : memories)
-                                                   {
-                                                       std::size_t found = sig.getSignalName().find(memory);
-                                                       
-                                                       if(found != std::string::npos)
-                                                       {
-                                                           trovato = true;
-                                                           //std::cout << "cell conn: " << sig.toString() << " ";
-                                                           //std::cout << "memory: " << memory << " connection found" << std::endl;
-                                                       }
-                                                   }
-                                                   
-                                                        
-                                               }
-                                               
-                                        }
-                                        
-                                        /*******Cases of a-priori known cell's ports direction ********/
-                                        
-										if ((cell->input(conn.first) && cell->output(conn.first)) || isInOut)
-										{
-											//2: INOUT
-											newPort->setDirection(Graph_Port::PortDirection::INOUT);
-                                            
-                                            this->setCellOutputModuleOutputBindings(cell, newPort, moduleOutputBindings, true);
-                                            
+								known = memorySignals.insert(std::make_pair(sig.getSignalId(), found)).first;
+							}
+
+							trovato = trovato || known->second;
+						}
+					}
+
+					//Then, foreach port of said node, we extract the info needed. The ports were created following the cell's connections.
+					int connIndex = -1;
+
+					for( auto &conn : cell->connections )
+					{
+						connIndex++;
+
+						auto portIndex = subcircuitNode.portMap.find(conn.port);
+
+						if(portIndex == subcircuitNode.portMap.end())
+						{
+							continue;
+						}
+
+						auto &subcircuitPort = subcircuitNode.ports[portIndex->second];
+
+						/*	DO NOT DELETE THIS
+							std::cout << "NodeId " << subCircuitId << ", PortId " << subcircuitNode.portMap[subcircuitPort.portId] << "\n";
+							std::cout << "Node " << subcircuitNode.nodeId << ", PortName " << subcircuitPort.portId << "\n\n";
+						//*/
+                            
+                        std::pair<bool, std::vector<Signal::Signal>> inOut = this->extractInoutPorts(cellSignals[connIndex].second);
+                        bool isInOut = inOut.first;
+
+						Graph_Port::Port *newPort = sg.createPort(subcircuitPort.portId, portIndex->second);
+                        
+                        /*******Cases of a-priori known cell's ports direction ********/
+                        
+						if ((conn.input && conn.output) || isInOut)
+						{
+							//2: INOUT
+							newPort->setDirection(Graph_Port::PortDirection::INOUT);
+                            
+                            this->setCellOutputModuleOutputBindings(cellSignals, newPort, moduleOutputs, true);
+                            
+                            for(auto inoutSignal : inOut.second)
+                            {
+                                newPort->pushInOutSignal(inoutSignal);
+                            }
+						}
+						else if (conn.input && !conn.output)
+						{
+							//0: INPUT
+							newPort->setDirection(Graph_Port::PortDirection::INPUT);
+						}
+						else if (!conn.input && conn.output )
+						{
+							//1: OUTPUT
+							newPort->setDirection(Graph_Port::PortDirection::OUTPUT);
+                            
+                            this->setCellOutputModuleOutputBindings(cellSignals, newPort, moduleOutputs, false);
+						}
+						else
+						{
+                            /**
+                             * *******Cases of a-priori unknown cell's ports direction ********
+                             * 
+                             * We reach this branch in case of (bad) design choiches in which we don't have
+                             * a specific bindings between the signals coming from the current module and 
+                             * the signals that goes in the inner module (so we cannot know which type of
+                             *port we are working on)
+                             */ 
+                            if((isModule) && (RTLIL_DUMPER::isValidPortID(subcircuitPort.portId)))
+                            {
+                                //The cell is a module placeholder and it's (unnamed) port connection is valid 
+                                
+                                //portValue = number associated to the inspecetd port (since it is not named but only numerated)
+                                int portValue = RTLIL_DUMPER::portIDDumper(subcircuitPort.portId).second;
+                                
+                                //The module of which our cell is the placeholder: we exploit its wires (external connections) in order to retrive the port names
+                                const std::vector<ModToGraph::PortSnapshot> &innerModule = design_modules.at(subcircuitNode.typeId);
+
+                                for(auto &imWire : innerModule)
+                                {
+                                    //Looking if the wire (external connection) id is the same of our port 
+                                    if(imWire.portId == portValue)
+                                    {
+                                       
+                                       //The port is still blank, it just takes the name of the inner module's wire
+                                       *newPort = Graph_Port::Port(imWire.name, portIndex->second);
+                                       
+                                       //INOUT cell
+                                       if((imWire.input) && (imWire.output))
+                                       {
+                                           newPort->setDirection(Graph_Port::PortDirection::INOUT);
+                                           
+                                           this->setCellOutputModuleOutputBindings(cellSignals, newPort, moduleOutputs, true);  
+                                           
                                             for(auto inoutSignal : inOut.second)
                                             {
                                                 newPort->pushInOutSignal(inoutSignal);
                                             }
-										}
-										else if (cell->input(conn.first) && !cell->output(conn.first))
-										{
-											//0: INPUT
-											newPort->setDirection(Graph_Port::PortDirection::INPUT);
-										}
-										else if (!cell->input(conn.first) && cell->output(conn.first) )
-										{
-											//1: OUTPUT
-											newPort->setDirection(Graph_Port::PortDirection::OUTPUT);
-                                            
-                                            this->setCellOutputModuleOutputBindings(cell, newPort, moduleOutputBindings, false);
-										}
-										else
-										{
-                                            /**
-                                             * *******Cases of a-priori unknown cell's ports direction ********
-                                             * 
-                                             * We reach this branch in case of (bad) design choiches in which we don't have
-                                             * a specific bindings between the signals coming from the current module and 
-                                             * the signals that goes in the inner module (so we cannot know which type of
-                                             *port we are working on)
-                                             */ 
-                                            if((isModule) && (RTLIL_DUMPER::isValidPortID(subcircuitPort.portId)))
-                                            {
-                                                //The cell is a module placeholder and it's (unnamed) port connection is valid 
-                                                
-                                                //portValue = number associated to the inspecetd port (since it is not named but only numerated)
-                                                int portValue = RTLIL_DUMPER::portIDDumper(subcircuitPort.portId).second;
-                                                bool found = false;
-                                                
-                                                //Looking inside other application modules to check if we see the module of which our cell is the placeholder
-                                                for(auto innerModule : module->design->modules())
-                                                {
-                                                    if(innerModule->name.str() == subcircuitNode.typeId)
-                                                    {
-                                                        //In case of match found, we have to exploit the module wires (external connections) in order to retrive the port names
-                                                        for(auto imWire : innerModule->wires())
-                                                        {
-                                                            //Looking if the wire (external connection) id is the same of our port 
-                                                            if(imWire->port_id == portValue)
-                                                            {
-                                                               
-                                                               newPort = new Graph_Port::Port(imWire->name.c_str(),
-                                                                                              subcircuitNode.portMap[subcircuitPort.portId]
-                                                                                             );
-                                                               
-                                                               //INOUT cell
-                                                               if((imWire->port_input) && (imWire->port_output))
-                                                               {
-                                                                   newPort->setDirection(Graph_Port::PortDirection::INOUT);
-                                                                   
-                                                                   this->setCellOutputModuleOutputBindings(cell, newPort, moduleOutputBindings, true);  
-                                                                   
-                                                                    for(auto inoutSignal : inOut.second)
-                                                                    {
-                                                                        newPort->pushInOutSignal(inoutSignal);
-                                                                    }
-                                                               }
-                                                               
-                                                               //INPUT cell
-                                                               if((imWire->port_input) && (!imWire->port_output))
-                                                               {
-                                                                    newPort->setDirection(Graph_Port::PortDirection::INPUT);
-                                                               }
-                                                               
-                                                               //OUTPUT cell
-                                                               if((!imWire->port_input) && (imWire->port_output))
-                                                               {
-                                                                    newPort->setDirection(Graph_Port::PortDirection::OUTPUT);
-                                                                    
-                                                                    this->setCellOutputModuleOutputBindings(cell, newPort, moduleOutputBindings, false);
-                                                               }
-                                                               
-                                                               found = true;
-                                                            }
-                                                            
-                                                            if(found)
-                                                            {
-                                                                break;
-                                                            }
-                                                        }
-                                                    }
-                                                    
-                                                    if(found)
-                                                    {
-                                                        break;
-                                                    }
-                                                }
-                                                
-                                            }
-                                            else
-                                            {
-                                                //Branch reached when we miss a module in the yosy call or a port binding is not valid
-                                                std::stringstream ss ;
+                                       }
+                                       
+                                       //INPUT cell
+                                       if((imWire.input) && (!imWire.output))
+                                       {
+                                            newPort->setDirection(Graph_Port::PortDirection::INPUT);
+                                       }
+                                       
+                                       //OUTPUT cell
+                                       if((!imWire.input) && (imWire.output))
+                                       {
+                                            newPort->setDirection(Graph_Port::PortDirection::OUTPUT);
                                             
-                                                ss << "\n\n************ ERROR: Module Declaration **********\n" ;
-                                                ss << "[Problem> {" << subcircuitNode.typeId << "} module declaration not provided or invalid port binding in .sv file, cannot preoceed\n\n" ;
+                                            this->setCellOutputModuleOutputBindings(cellSignals, newPort, moduleOutputs, false);
+                                       }
+                                       
+                                       break;
+                                    }
+                                }
+                                
+                            }
+                            else
+                            {
+                                //Branch reached when we miss a module in the yosy call or a port binding is not valid
+                                std::stringstream ss ;
+                            
+                                ss << "\n\n************ ERROR: Module Declaration **********\n" ;
+                                ss << "[Problem> {" << subcircuitNode.typeId << "} module declaration not provided or invalid port binding in .sv file, cannot preoceed\n\n" ;
+
+                                this->buildMessage(ss.str() + "\n", false);
+                                return false;
+                            }
+                           
+						}
 
-                                                std :: cout << ss.str() << std::endl;
-                                                return false;
-                                            }
-                                           
-										}
-
-										//Each edge is a single bit signal.
-										for( auto bit : subcircuitPort.bits )
-										{
-											newPort->addEdge( bit.edgeIdx);
-										}
-
-										//Retrieve the connection between ports and externalSignals.
-										std::string logSig = log_signal( sigmap(conn.second) );
-										std::vector< std::pair< std::string, std::pair<int,int> > > filtered;
-										//Extraction of all the connections of a port (both signals and other ports)
-										std::pair<bool, std::vector<Signal::Signal>> dumpedSignals = RTLIL_DUMPER::sigSpecDumper(sigmap(conn.second));
-
-										//Extract the specification from the signal logSig used for discriminating among signals and ports I/Os
-										for( auto sigSpecs : StringSupport::extractSignals(logSig) )
-										{
-											//Push back to the vector all the needed info to build the signal later
-											filtered.push_back( std::make_pair(sigSpecs.first, std::make_pair(sigSpecs.second.second, sigSpecs.second.first) ) );
-										}
-
-										//Vector that contains only Signals connected to the port
-										std::vector<Signal::Signal> realSignals ;
-
-										//Adding only real port signals to our port
-										for(auto f : filtered)
-										{
-											for(auto ds : dumpedSignals.second)
-											{
-												//If the dumped signal name corresponds to a real signal (not another port input/output)...
-												if(f.first == ds.getSignalName()) 
-												{
-													realSignals = VectorSupport::conditionalInsert(realSignals, ds);
-												}
-											}
-										}
-
-										//I trust the assignment done previously in this function, so I use them to assign the port to the rightful queue
-										switch(newPort->getPortDirection())
-										{
-											case Graph_Port::PortDirection::INPUT:
-
-												for(auto rs : realSignals)
-												{
-													newPort->pushInputSignal(rs);
-												}
-												newNode->addPort(newPort, Graph_Port::PortDirection::INPUT);
-                                               
-											break;
-
-											case Graph_Port::PortDirection::OUTPUT:
-												if(conn.second.is_wire())
-												{
-
-													for(auto rs : realSignals)
-													{
-														newPort->pushOutputSignal(rs);
-													}
-                                                    
-												}
-                                                newNode->addPort(newPort, Graph_Port::PortDirection::OUTPUT);	
-                                                 if(trovato)
-                                                    newPort->setConnectionToExtern(true);
-                                                break;
-
-											case Graph_Port::PortDirection::INOUT:
-												for(auto rs : realSignals)
-												{
-													newPort->pushInOutSignal(rs);
-												}
-												newNode->addPort(newPort, Graph_Port::PortDirection::INOUT);
-                                                if(trovato)
-                                                    newPort->setConnectionToExtern(true);
-												break;
-
-											default:
-												return false;
-										}	
+						//Each edge is a single bit signal.
+						for( auto &bit : subcircuitPort.bits )
+						{
+							newPort->addEdge( bit.edgeIdx);
+						}
+
+						//Retrieve the connection between ports and externalSignals: only real signals (not other ports' I/Os) are connected to the port
+						const std::vector<Signal::Signal> &realSignals = conn.realSignals;
+
+						//I trust the assignment done previously in this function, so I use them to assign the port to the rightful queue
+						switch(newPort->getPortDirection())
+						{
+							case Graph_Port::PortDirection::INPUT:
+
+								for(auto rs : realSignals)
+								{
+									newPort->pushInputSignal(rs);
+								}
+								newNode->addPort(newPort, Graph_Port::PortDirection::INPUT);
+                               
+							break;
+
+							case Graph_Port::PortDirection::OUTPUT:
+								if(conn.isWire)
+								{
+
+									for(auto rs : realSignals)
+									{
+										newPort->pushOutputSignal(rs);
 									}
+                                    
 								}
-							}
-						}
+                                newNode->addPort(newPort, Graph_Port::PortDirection::OUTPUT);	
+                                 if(trovato)
+                                    newPort->setConnectionToExtern(true);
+                                break;
+
+							case Graph_Port::PortDirection::INOUT:
+								for(auto rs : realSignals)
+								{
+									newPort->pushInOutSignal(rs);
+								}
+								newNode->addPort(newPort, Graph_Port::PortDirection::INOUT);
+                                if(trovato)
+                                    newPort->setConnectionToExtern(true);
+								break;
+
+							default:
+								return false;
+						}	
 					}
+				}
 				sg.addNode(newNode);
 			}
 
@@ -723,22 +624,82 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 			return true;
 		}
 
+		/*
+		 *	Fills signalConsumers and inoutSignals_byName, once the graph is complete
+		 */
+		void Generator::Generator::buildSignalIndex()
+		{
+			this->signalConsumers.clear();
+			this->inoutSignals_byName.clear();
+
+			for( auto node : sg.getNodes() )
+			{
+				for( auto port : node->getInputs() )
+				{
+					int role = CellRepository::NO_PORT_ROLE;
+
+					if(!node->isModulePlaceholder())
+					{
+						role = sg.getCellRepository()->isSelectionPort( node->getType(), port->getPortName() ) ? CellRepository::SELECTION_INPUT_ROLE : CellRepository::DATA_INPUT_ROLE;
+					}
+
+					for( auto &inputSignal : port->getInputSignals() )
+					{
+						SignalConsumer consumer;
+						consumer.node = node;
+						consumer.port = port;
+						consumer.signal = inputSignal;
+						consumer.role = role;
+
+						this->signalConsumers[inputSignal.getSignalId()].push_back(consumer);
+					}
+
+					if(port->isInOutPort())
+					{
+						for( auto &sig : port->getSignals() )
+						{
+							this->inoutSignals_byName.insert(sig.getSignalId());
+						}
+					}
+				}
+			}
+		}
+
 		/*
 		 *	Functions that builds the final graph and then s it.
 		 */
-		bool Generator::Generator::buildConsistentGraph(SubCircuit_v2::Graph& myg, RTLIL::Module *module, bool verbose)
+		bool Generator::Generator::buildConsistentGraph(SubCircuit_v2::Graph& myg, const ModToGraph::ModuleSnapshot &module, bool verbose)
 		{
-			//Graph was not generated correctly.
-			if(!buildGraph(myg, module))
+			bool built = false;
+
 			{
-				log("\tError while building graph...\n\n");
-				return false;
+				Profiler::PhaseTimer timer(Profiler::PHASE_BUILD_GRAPH);
+
+				built = buildGraph(myg, module);
+
+				//Graph was not generated correctly.
+				if(!built)
+				{
+					this->buildMessage("\tError while building graph...\n\n");
+					return false;
+				}
+
+				//The graph won't change anymore, index the edges once so that the traversals don't rescan the whole module at each step.
+				sg.buildEdgeIndex();
+				//Same for the ports reading each signal
+				this->buildSignalIndex();
+			}
+
+			bool consistent = false;
+			{
+				Profiler::PhaseTimer timer(Profiler::PHASE_CHECK);
+				consistent = check(verbose);
 			}
 
 			//Graph did not pass consistency tests (more dangerous than the first exit)
-			if(!check(verbose))
+			if(!consistent)
 			{
-				log("\tError while checking graph...\n\n");
+				this->buildMessage("\tError while checking graph...\n\n");
 				return false;
 			}
 
@@ -755,15 +716,8 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 			//Foreach entering signal
 			for( auto externalSig : this->enteringSignals )
 			{
-				std::vector<char> externalSignalWidthSupport;
-
-				//Push a 'false' foreach bit of that signal
-				for( int i=0; i<externalSig.width(); i++ )
-				{
-					externalSignalWidthSupport.push_back(NONE);
-				}
-
-				sliceStructure.push_back( std::make_pair(externalSig, externalSignalWidthSupport) );
+				//Every bit of that signal starts as NONE
+				sliceStructure.push_back( std::make_pair(externalSig, SlicePlanes::SlicePlanes(externalSig.width())) );
 			}
 		}
 
@@ -776,7 +730,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		{
 			if(verbose)
 			{
-				log("Checking the validity of ports' direction...\n");
+				this->buildMessage("Checking the validity of ports' direction...\n");
 			}
 
 			bool ok = true;
@@ -788,7 +742,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 					if( port->isInvalidPort() )
 					{
 						ok = false;
-						std::cout << "Invalid input port found:\n" << node->toString() << " in port: " << port->toString() << std::endl;
+						this->buildMessage("Invalid input port found:\n" + node->toString() + " in port: " + port->toString() + "\n", false);
 					}
 				}
 			}
@@ -807,7 +761,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		{
 			if(verbose)
 			{
-				log("Checking the validity of ports' id...\n");
+				this->buildMessage("Checking the validity of ports' id...\n");
 			}
 
 			bool ok = true;
@@ -837,7 +791,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		{
 			if(verbose)
 			{
-				log("Checking connections to outer signals...\n");
+				this->buildMessage("Checking connections to outer signals...\n");
 			}
 
 			bool ok = true;
@@ -867,7 +821,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		{
 			if(verbose)
 			{
-				log("Counting the number of the nodes...\n");
+				this->buildMessage("Counting the number of the nodes...\n");
 			}
 
 			if( (int)sg.getNodes().size() == sg.getNumOfNodes() )
@@ -884,7 +838,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		{
 			if(verbose)
 			{
-				log("Checking consistency of port vectors...\n");
+				this->buildMessage("Checking consistency of port vectors...\n");
 			}
 
 			for( auto node : sg.getNodes() )
@@ -895,7 +849,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 					{
 						if( (int)inputPort->getOutputSignals().size() > 0 )
 						{
-							log("Found input port with non-empty output signals.\n");
+							this->buildMessage("Found input port with non-empty output signals.\n");
 							return 0;
 						}
 					}
@@ -907,7 +861,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 					{
 						if( (int)outputPort->getInputSignals().size() > 0 )
 						{
-							log("Found output port with non-empty input signals.\n");
+							this->buildMessage("Found output port with non-empty input signals.\n");
 							return 0;
 						}
 					}
@@ -924,7 +878,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		{
 			if(verbose)
 			{
-				log("Checking node analysis' methods consistency...\n");
+				this->buildMessage("Checking node analysis' methods consistency...\n");
 			}
 
 			std::vector<Graph_Node::Node *> starting;
@@ -957,14 +911,14 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		{
 			if(verbose)
 			{
-				log("Checking support structure's consistency...\n");
+				this->buildMessage("Checking support structure's consistency...\n");
 			}
 
 			for( auto sig : this->enteringSignals )
 			{
-				for( auto pair : this->sliceStructure )
+				for( const auto &pair : this->sliceStructure )
 				{
-					if( sig.getSignalName() == pair.first.getSignalName() )
+					if( sig.getSignalId() == pair.first.getSignalId() )
 					{
 						if( sig.width() != (int)pair.second.size() )
 						{
@@ -995,7 +949,7 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 
 			if(verbose)
 			{
-				std::cout << "\nCheck completed succefully: " << checkCount << "/" << CHECK_NUMBER << ".\n" << std::endl;
+				this->buildMessage("\nCheck completed succefully: " + std::to_string(checkCount) + "/" + std::to_string(CHECK_NUMBER) + ".\n\n", false);
 			}
 
 			if(checkCount==CHECK_NUMBER)
@@ -1008,25 +962,66 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		//=================================================================================================================================== CHECK_END
 
 		//Constructor
-		Generator::Generator::Generator(SubCircuit_v2::Graph& myg, RTLIL::Module *module, bool verbose) : SubCircuit_v2::Graph()
+		Generator::Generator::Generator(SubCircuit_v2::Graph& myg, RTLIL::Module *module, bool verbose, bool deferLog) : SubCircuit_v2::Graph()
 		{
-            std::string log_string = "\n\t=========={ Building module: " + module->name.str() + " structure }==========";
-            std::cout << log_string << std::endl;
+			this->deferredLog = deferLog;
+
+			//The only part of the build that reads RTLIL, one module at a time: the graphs are built from the snapshot concurrently
+			ModToGraph::ModuleSnapshot snapshot;
+			{
+				Profiler::PhaseTimer timer(Profiler::PHASE_BUILD_GRAPH);
+				std::lock_guard<std::mutex> guard(ThreadPool::kernelMutex());
+				snapshot = ModToGraph::snapshotModule(module);
+			}
+
+            std::string log_string = "\n\t=========={ Building module: " + snapshot.name + " structure }==========";
+            this->buildMessage(log_string + "\n", false);
 			                
-			log("\tBuilding backbone graph ...\n");
+			this->buildMessage("\tBuilding backbone graph ...\n");
 			//If either something in the generation or one check fails, nothing can proceed accordingly to our analysis.
-			if(!buildConsistentGraph(myg, module, verbose))
+			if(!buildConsistentGraph(myg, snapshot, verbose))
 			{
-				log("Graph inconsistent, terminating execution...\n");
-				abort();
+				//Whoever built the Generator reports the failure, on the main thread (see isConsistent)
+				this->buildMessage("Graph inconsistent, terminating execution...\n");
+				this->consistent = false;
+				return;
 			}
-			log("\tGraph is consistent.\n");
+			this->buildMessage("\tGraph is consistent.\n");
            
-			log("\tGenerating support structures...\n");
+			this->buildMessage("\tGenerating support structures...\n");
             
 			this->prepareSlices();
-            
-			log("\tStructures ready.\n\n");
+
+			this->buildMessage("\tGraph storage: " + std::to_string(sg.getNodes().size()) + " nodes, " + std::to_string(sg.getStorageBytes() / 1024) + " KB of node and port arenas.\n");
+			this->buildMessage("\tStructures ready.\n\n");
+		}
+
+		void Generator::Generator::buildMessage(std::string text, bool toLog)
+		{
+			if(this->deferredLog)
+			{
+				this->buildLog.push_back(std::make_pair(toLog, text));
+			}
+			else if(toLog)
+			{
+				log("%s", text.c_str());
+			}
+			else
+			{
+				std::cout << text << std::flush;
+			}
+		}
+
+		void Generator::Generator::flushBuildLog()
+		{
+			this->deferredLog = false;
+
+			for(auto message : this->buildLog)
+			{
+				this->buildMessage(message.second, message.first);
+			}
+
+			this->buildLog.clear();
 		}
 		
 		/*
@@ -1041,43 +1036,35 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 				temp.push_back(sig);
 			}
 
-			for( auto node : sg.getNodes())
+			//Slices of the same signal entering some port: we need to push one only if the same dimensions are not in the temp already
+			for( auto &consumer : getSignalConsumers(sig.getSignalId()) )
 			{
-				for( auto inputPort : node->getInputs() )
+				const Signal::Signal &inputSignal = consumer.signal;
+				bool isIn = false;
+
+				for( auto &alreadyIn : temp )
 				{
-					for( auto inputSignal : inputPort->getInputSignals() )
+					if( (inputSignal.getMSB() == alreadyIn.getMSB()) && ( inputSignal.getLSB() == alreadyIn.getLSB() ) )
 					{
-						//If the signal name is the same, we need to push it only if the same dimensions are not in the temp already
-						if( sig.getSignalName() == inputSignal.getSignalName() )
-						{
-							bool isIn = false;
-
-							for( auto alreadyIn : temp )
-							{
-								if( (inputSignal.getMSB() == alreadyIn.getMSB()) && ( inputSignal.getLSB() == alreadyIn.getLSB() ) )
-								{
-									isIn = true;
-								}
-							}
-
-							if(!isIn)
-							{
-								temp.push_back(inputSignal);
-							}
-						}
+						isIn = true;
+						break;
 					}
-					
+				}
+
+				if(!isIn)
+				{
+					temp.push_back(inputSignal);
 				}
 			}
 			
 			//In this section we check if the signal is directly connected to the output
 			for(auto exitingSignal : exitingSignals)
             {
-                for(auto couple : coupledSignals)
+                for(auto &couple : pairedSignals)
                 {
-                    if(couple.first.compare(exitingSignal.getSignalName())==0)
+                    if(couple.first.getSignalId() == exitingSignal.getSignalId())
                     {
-                        if(couple.second.compare(sig.getSignalName()) == 0)
+                        if(couple.second.getSignalId() == sig.getSignalId())
                         {
                             temp.push_back(exitingSignal);
                         }
@@ -1117,72 +1104,62 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 				ss << "\tAllowed execution..\n\n";
 			}
 			
-			//Foreach node
-			for( auto node : sg.getNodes() )
+			//Nodes already in starting
+			std::unordered_set<Graph_Node::Node *> inserted;
+
+			//Foreach port reading the signal (the name is the same, width has not been considered yet)
+			for( auto &consumer : getSignalConsumers(externalSignal.getSignalId()) )
 			{
-				if(verbose)
-				{
-					ss << "\tNode : " << node->getName() << "\n";
-				}
+				Graph_Node::Node *node = consumer.node;
+				Graph_Port::Port *port = consumer.port;
 
-				//Foreach port of that node
-				for( auto port : node->getInputs() )
+				if( consumer.signal == externalSignal )
 				{
 					if(verbose)
 					{
-						ss << "\t\tPort : " << port->getPortName() << "\n";
+						ss << "\tNode : " << node->getName() << ", Port : " << port->getPortName() << "\n";
+						ss << "\t\t\t\tFound signal match: " << consumer.signal.getSignalName() << " [" << consumer.signal.getMSB() << ":" << consumer.signal.getLSB() << "]\n";
 					}
+					
+					//If we're discriminating, then we check. If we're not, we simply keep entersSelection=false so that the next check collapses to the first condition only
+					bool entersSelection = false;
 
-					//Foreach entering signal
-					for( auto inputSignal : port->getInputSignals() )
+					if((discriminating) && (!node->isModulePlaceholder()))
 					{
-						ss << "\t\t\tChecking for presence of : " << inputSignal.getSignalName() << "\n";
-						//The name is the same, width has not been considered yet
-						if( (inputSignal.getSignalName() == externalSignal.getSignalName()) && (inputSignal.getMSB() == externalSignal.getMSB()) && (inputSignal.getLSB() == externalSignal.getLSB()))
+						if( consumer.role == CellRepository::SELECTION_INPUT_ROLE )
 						{
-							ss << "\t\t\t\tFound signal match: " << inputSignal.getSignalName() << " [" << inputSignal.getMSB() << ":" << inputSignal.getLSB() << "]\n";;
-							
-							//If we're discriminating, then we check. If we're not, we simply keep entersSelection=false so that the next check collapses to the first condition only
-							bool entersSelection = false;
-
-							if((discriminating) && (!node->isModulePlaceholder()))
-							{
-								if( VectorSupport::isIn( (sg.getCellRepository()->getCell(node->getType()))->getSelectionInputs(), port->getPortName() ) )
-								{
-									entersSelection = true;
-								}
-							}
-							
-							if((discriminating) && (node->isModulePlaceholder()))
-							{
-								for(auto selectionInput : node->getModuleSelectionPorts())
+							entersSelection = true;
+						}
+					}
+					
+					if((discriminating) && (node->isModulePlaceholder()))
+					{
+						for(auto selectionInput : node->getModuleSelectionPorts())
+                        {
+                            if(selectionInput->getPortName().compare(port->getPortName()) == 0)
+                            {
+                                entersSelection = true;
+                                            
+                                for(auto dataInput : node->getModuleDataPorts())
                                 {
-                                    if(selectionInput->getPortName().compare(port->getPortName()) == 0)
+                                    if(dataInput->getPortName().compare(selectionInput->getPortName()) == 0)
                                     {
-                                        entersSelection = true;
-                                                    
-                                        for(auto dataInput : node->getModuleDataPorts())
-                                        {
-                                            if(dataInput->getPortName().compare(selectionInput->getPortName()) == 0)
-                                            {
-                                                entersSelection = false;
-                                            }
-                                        }
-                                                    
+                                        entersSelection = false;
                                     }
                                 }
-							}
+                                            
+                            }
+                        }
+					}
 
-							//If the node is already there, do not insert it. The signalMatchCount supports multiple signal inputs.
-							if( !VectorSupport::isIn(starting, node) && !entersSelection )
-							{
-								if(verbose)
-								{
-									ss << "\t\t\tInserting startingNode: " << node->getName() << "\n";
-								}
-								starting.push_back(node);
-							}
+					//If the node is already there, do not insert it. The signalMatchCount supports multiple signal inputs.
+					if( !entersSelection && inserted.insert(node).second )
+					{
+						if(verbose)
+						{
+							ss << "\t\t\tInserting startingNode: " << node->getName() << "\n";
 						}
+						starting.push_back(node);
 					}
 				}
 			}
@@ -1230,57 +1207,39 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 				ss << "\tAllowed execution..\n\n";
 			}
 			
-			//Foreach node
-			for( auto node : sg.getNodes() )
+			//Nodes already in starting
+			std::unordered_set<Graph_Node::Node *> inserted;
+
+			//Foreach port reading the signal: the name is the same, width is not considered
+			for( auto &consumer : getSignalConsumers(externalSignal.getSignalId()) )
 			{
+				Graph_Node::Node *node = consumer.node;
+
 				if(verbose)
 				{
-					ss << "\tNode : " << node->getName() << "\n";
+					ss << "\tNode : " << node->getName() << ", Port : " << consumer.port->getPortName() << "\n";
+					ss << "\t\t\t\tFound signal match: " << consumer.signal.getSignalName() << " [" << consumer.signal.getMSB() << ":" << consumer.signal.getLSB() << "]\n";
 				}
+				
+				//If we're discriminating, then we check. If we're not, we simply keep entersSelection=false so that the next check collapses to the first condition only
+				bool entersSelection = false;
 
-				//Foreach port of that node
-				for( auto port : node->getInputs() )
+				if((discriminating) && (!node->isModulePlaceholder()))
 				{
-					if(verbose)
-					{
-						ss << "\t\tPort : " << port->getPortName() << "\n";
-					}
+                    if( consumer.role == CellRepository::SELECTION_INPUT_ROLE )
+                    {
+                        entersSelection = true;
+                    }
+				}
 
-					//Foreach entering signal
-					for( auto inputSignal : port->getInputSignals() )
+				//If the node is already there, do not insert it. The signalMatchCount supports multiple signal inputs.
+				if( !entersSelection && inserted.insert(node).second )
+				{
+					if(verbose)
 					{
-						ss << "\t\t\tChecking for presence of : " << inputSignal.getSignalName() << "\n";
-						//The name is the same, width has not been considered yet
-						if( ( inputSignal.getSignalName() == externalSignal.getSignalName()) )
-						{
-							ss << "\t\t\t\tFound signal match: " << inputSignal.getSignalName() << " [" << inputSignal.getMSB() << ":" << inputSignal.getLSB() << "]\n";;
-							
-							//If we're discriminating, then we check. If we're not, we simply keep entersSelection=false so that the next check collapses to the first condition only
-							bool entersSelection = false;
-
-							if((discriminating) && (!node->isModulePlaceholder()))
-							{
-                                if(!node->isModulePlaceholder())
-                                {
-                                    if( VectorSupport::isIn( (sg.getCellRepository()->getCell(node->getType()))->getSelectionInputs(), port->getPortName() ) )
-                                    {
-                                        entersSelection = true;
-                                    }
-                                }
-								
-							}
-
-							//If the node is already there, do not insert it. The signalMatchCount supports multiple signal inputs.
-							if( !VectorSupport::isIn(starting, node) && !entersSelection )
-							{
-								if(verbose)
-								{
-									ss << "\t\t\tInserting startingNode: " << node->getName() << "\n";
-								}
-								starting.push_back(node);
-							}
-						}
+						ss << "\t\t\tInserting startingNode: " << node->getName() << "\n";
 					}
+					starting.push_back(node);
 				}
 			}
 
@@ -1303,43 +1262,49 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 		 *	Find a correspondant among the coupledSignals. If getNew, we search for a forward renaming y such that x -> y, otherwise x <- y
 		 *	<newName , oldName>
 		 */
-		std::string Generator::Generator::getRenaming(std::string signalName, bool getNew)
+		int Generator::Generator::getRenaming(int signalId, bool getNew)
 		{
-			for( auto pair : this->coupledSignals )
-			{
-				if(getNew)
-				{
-					//Old name is in the pair.second
-					if( signalName == pair.second )
-					{
-						return pair.first;
-					}
-				}
-				else
-				{
-					//New name is in the pair.first
-					if( signalName == pair.first )
-					{
-						return pair.second;
-					}	
-				}
-			}
-			return "";
+			//Old name is in the pair.second, new name in pair.first
+			const std::unordered_map<int, int> &renaming = getNew ? this->renamedTo : this->renamedFrom;
+			auto found = renaming.find(signalId);
+
+			return (found != renaming.end()) ? found->second : -1;
 		}
 
 		/*
 		 *	Is the signal passed an external signal
 		 */
-		bool Generator::Generator::isExternalSignal_byNameOnly(Signal::Signal signal)
+		bool Generator::Generator::isExternalSignal_byNameOnly(const Signal::Signal &signal)
 		{
-			for( auto sig : this->externalSignals )
-			{
-				if( signal.getSignalName() == sig.getSignalName() )
-				{
-					return true;
-				}
-			}
-			return false;
+			return this->externalByName.count(signal.getSignalId()) > 0;
+		}
+
+		/*
+		 *	Is the signal passed the new name of a renaming, i.e. is it directly driven by a connection of the module (see coupledSignals)
+		 */
+		bool Generator::Generator::isCoupledSignal_byNameOnly(const Signal::Signal &signal)
+		{
+			return this->renamedFrom.count(signal.getSignalId()) > 0;
+		}
+
+		/*
+		 *	Ports reading the signal with the given name id, whatever the slice (see SignalConsumer). Empty if the signal enters no port.
+		 */
+		const std::vector<Generator::SignalConsumer> &Generator::Generator::getSignalConsumers(int signalId)
+		{
+			static const std::vector<SignalConsumer> none;
+
+			auto found = this->signalConsumers.find(signalId);
+
+			return (found != this->signalConsumers.end()) ? found->second : none;
+		}
+
+		/*
+		 *	Does the signal reach an inout port of the module (considered only in name)
+		 */
+		bool Generator::Generator::isInOutSignal_byNameOnly(const Signal::Signal &signal)
+		{
+			return this->inoutSignals_byName.count(signal.getSignalId()) > 0;
 		}
 		
 		/*
@@ -1394,23 +1359,15 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
 
 		/*
 		 *	Method to transform the support structure in a string.
-		 *	std::vector< std::pair< Signal::Signal, std::vector<char> > >
 		 */
 		std::string Generator::Generator::condenseBit()
 		{
 			std::stringstream ss;
 			
-			for( auto pair : this->sliceStructure)
+			for( const auto &pair : this->sliceStructure )
 			{
 				ss << "\t" << pair.first.toString();
-				ss << " [";
-
-				for( int i=(int)pair.second.size()-1; i>=0; i--)
-				{
-					ss << pair.second[i];
-				}
-
-				ss << "]\n\n";
+				ss << " [" << pair.second.toString() << "]\n\n";
 			}
 
 			return ss.str();
@@ -1430,20 +1387,21 @@ char Generator::nextLetter( char currentCode, std::pair<bool, bool> data_select
         }
 
 		//Getters
-		std::string Generator::Generator::getModuleName(){ return this->moduleName; }
-		SupportGraph::SupportGraph Generator::Generator::getSupportGraph(){return this->sg; }
-		std::vector<Signal::Signal> Generator::Generator::getEnteringSignals(){ return this->enteringSignals; }
-		std::vector<Signal::Signal> Generator::Generator::getExitingSignals(){ return this->exitingSignals; }
-		std::vector<Signal::Signal> Generator::Generator::getExternalSignals() { return this->externalSignals; }
-		std::vector<std::pair< Signal::Signal, std::vector<char> > > Generator::Generator::getSliceStructure() { return this->sliceStructure; }
-		std::vector<std::pair<std::string, std::string> > Generator::Generator::getCoupledSignals() { return this->coupledSignals; }
-		std::vector<std::pair<Signal::Signal, Signal::Signal>> Generator::Generator::getPairedSignals(){return this->pairedSignals;}
-		std::vector<std::pair<std::string,std::string>> Generator::Generator::getInnerModules(){return this->innerModules; }
-		std::vector<Signal::Signal> Generator::Generator::getInoutSignals(){return this->inoutSignals; }
+		const std::string &Generator::Generator::getModuleName() const { return this->moduleName; }
+		SupportGraph::SupportGraph& Generator::Generator::getSupportGraph(){return this->sg; }
+		const std::vector<Signal::Signal> &Generator::Generator::getEnteringSignals() const { return this->enteringSignals; }
+		const std::vector<Signal::Signal> &Generator::Generator::getExitingSignals() const { return this->exitingSignals; }
+		const std::vector<Signal::Signal> &Generator::Generator::getExternalSignals() const { return this->externalSignals; }
+		const SlicePlanes::SliceStructure &Generator::Generator::getSliceStructure() const { return this->sliceStructure; }
+		SlicePlanes::SliceStructure &Generator::Generator::getSliceStructure() { return this->sliceStructure; }
+		const std::vector<std::pair<std::string, std::string> > &Generator::Generator::getCoupledSignals() const { return this->coupledSignals; }
+		const std::vector<std::pair<Signal::Signal, Signal::Signal>> &Generator::Generator::getPairedSignals() const {return this->pairedSignals;}
+		const std::vector<std::pair<std::string,std::string>> &Generator::Generator::getInnerModules() const {return this->innerModules; }
+		const std::vector<Signal::Signal> &Generator::Generator::getInoutSignals() const {return this->inoutSignals; }
         
-		void Generator::Generator::setSliceStructure( std::vector< std::pair< Signal::Signal, std::vector<char> > > structure )
+		void Generator::Generator::setSliceStructure( SlicePlanes::SliceStructure structure )
 		{
-			this->sliceStructure = structure;
+			this->sliceStructure = std::move(structure);
 		}
 
 		//Classic toString method
@@ -20,8 +20,13 @@
 #ifndef GENERATOR_H
 #define GENERATOR_H
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "supportGraph.h"
 #include "circuit.h"
+#include "module_to_graph.h"
+#include "slice_planes.h"
 
 //To elaborate RTLIL::Design
 #include "kernel/yosys.h"
@@ -29,21 +34,22 @@
 
 #define CHECK_NUMBER 7
 
-#define NONE 'N'
-#define SELECT 'S'
-#define DATA 'D'
-#define BOTH 'B'
-#define ERROR_CODE 'E'
-
 namespace Generator
 {
 
 	/*
-	 *	Decides what letter the support structure shall contain for each bit of each signal.
-	 *	NB: downgrades are not feasible. A signal which has been recognized as SELECT somewhere will forever remain at least a SELECT signal, that's
-	 *	why there are some 'return currentCode'.
+	 *	An input (or inout) port reading a slice of a signal: one entry of the signal index of a Generator.
 	 */
-	char nextLetter( char currentCode, std::pair<bool, bool> data_select );
+	struct SignalConsumer
+	{
+		Graph_Node::Node *node;
+		Graph_Port::Port *port;
+		//The slice of the signal entering the port
+		Signal::Signal signal;
+		//CellRepository::PortRole of the port (DATA_INPUT_ROLE or SELECTION_INPUT_ROLE) for cells, NO_PORT_ROLE for module placeholders:
+		//their roles are only known once the inner module has been analyzed
+		int role;
+	};
 
 	/*	
 	 *	Now this is tricky. What we'll output is a ConfiguratorGraph (cg), but why we need
@@ -70,6 +76,24 @@ namespace Generator
 			std::vector< std::pair<std::string, std::string> > coupledSignals;
             //Vector that contains all the infos related to coupled signals
             std::vector< std::pair<Signal::Signal,Signal::Signal>> pairedSignals;
+            /*
+             * Name indexes (by interned name id) over the vectors above, filled together with them (see addSignal). When a name appears more
+             * than once the first entry wins, as it did for the linear searches they replace.
+             */
+            std::unordered_map<int, Signal::Signal> externalByName; //name -> external signal
+            std::unordered_map<int, Signal::Signal> enteringByName;
+            std::unordered_map<int, Signal::Signal> exitingByName;
+            std::unordered_map<int, Signal::Signal> inoutByName;
+            std::unordered_map<int, int> renamedTo;   //oldName -> newName
+            std::unordered_map<int, int> renamedFrom; //newName -> oldName
+
+            /*
+             * Signal index: for each name id, the input signals of the ports that read it, in the order of a sweep over nodes, input ports
+             * and their input signals. Lets the queries on a signal cost as its fan-out instead of the module size.
+             */
+            std::unordered_map<int, std::vector<SignalConsumer>> signalConsumers;
+            //Names carried by inout ports
+            std::unordered_set<int> inoutSignals_byName;
             //Set of modules that are instantiated inside the current module (used to state if a module is atomic or not)
             std::vector<std::pair<std::string, std::string>> innerModules;
 
@@ -77,7 +101,22 @@ namespace Generator
 			 *	Support for bit condensing. NB: to ease the procedures involving this structure, here signals are contained in a [LSB:MSB] fashion.
 			 *	This is done to avoid strange measures for accessing the vector of the signal
 			 */
-			std::vector< std::pair< Signal::Signal, std::vector<char> > > sliceStructure;
+			SlicePlanes::SliceStructure sliceStructure;
+
+			/*
+			 *	Messages of the build, kept back when the Generator is built on a worker thread so that they can be replayed in module order.
+			 *	Each entry is <goes to the log (true) or to std::cout (false), text>.
+			 */
+			bool deferredLog = false;
+			std::vector< std::pair<bool, std::string> > buildLog;
+
+			//Outcome of the build
+			bool consistent = true;
+
+			/*
+			 *	Writes a build message, or keeps it back if the log is deferred.
+			 */
+			void buildMessage(std::string text, bool toLog=true);
 
 			//=================================================================================================================================== GRAPH_BEGIN
 
@@ -97,35 +136,45 @@ namespace Generator
             /*
              * Method used for extracting the connections between internal cells outputs and the module's outputs
              */
-            std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> extractModuleOutputBinding(RTLIL::Module *module);
+            std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> extractModuleOutputBinding(const ModToGraph::ModuleSnapshot &module);
             
             /*
              * Method used for knowing if a specific cell's output has some bindings with the module's outputs
              * (i.e. this method as to be called only in case of output/inout cells, NOT in case of input ones ,
              * since this method only exploits output connections between a cell and a module)
              */
-            void setCellOutputModuleOutputBindings(  RTLIL::Cell *cell, //RTLIL::Cell that we want to inspect
+            void setCellOutputModuleOutputBindings(  const std::vector<std::pair<bool, std::vector<Signal::Signal>>> &cellSignals, //Dumped connections of the RTLIL::Cell that we want to inspect
                                                      Graph_Port::Port *newPort, //Port that we have created for our purposes
-                                                     std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> moduleOutputBindings, //Binding of the module with the extern
+                                                     const dict<Signal::Signal, int> &moduleOutputs, //Module's outputs bound to internal cells, with their multiplicity
                                                      bool inout //Boolean flag used to decree if the port is an inout port (true -> inout port, false->output port)
                                                     );
 
             /*
              * Method used for determine if a specific port is an InOut port and which signals 
-             * are connected to that port in such case
+             * are connected to that port in such case (connSignals is the dump of the port's connection)
              */
-            std::pair<bool, std::vector<Signal::Signal>> extractInoutPorts(RTLIL::SigSpec conn);
+            std::pair<bool, std::vector<Signal::Signal>> extractInoutPorts(const std::vector<Signal::Signal> &connSignals);
+
+            /*
+             * Appends signal to signals unless a signal with its name is already there, keeping the name index byName in step
+             */
+            static void addSignal(std::vector<Signal::Signal> &signals, std::unordered_map<int, Signal::Signal> &byName, const Signal::Signal &signal);
 
 
 			/*
-			 *	This method generates the final graph by taking the default subcircuit graph and the design.
+			 *	This method generates the final graph by taking the default subcircuit graph and the snapshot of the module.
 			 */
-			bool buildGraph(SubCircuit_v2::Graph& myg, RTLIL::Module *module);
+			bool buildGraph(SubCircuit_v2::Graph& myg, const ModToGraph::ModuleSnapshot &module);
+
+			/*
+			 *	Fills signalConsumers and inoutSignals_byName, once the graph is complete
+			 */
+			void buildSignalIndex();
 
 			/*
 			 *	Functions that builds the final graph and then s it.
 			 */
-			bool buildConsistentGraph(SubCircuit_v2::Graph& myg, RTLIL::Module *module, bool verbose=false);
+			bool buildConsistentGraph(SubCircuit_v2::Graph& myg, const ModToGraph::ModuleSnapshot &module, bool verbose=false);
 			
             /*
 			 *	Returns the structure we need to perform bit condensing.
@@ -184,8 +233,22 @@ namespace Generator
 
 
 		public:
-			//Constructor
-			Generator(SubCircuit_v2::Graph& myg, RTLIL::Module *module, bool verbose=false);
+			/*
+			 *	Constructor. With deferLog the build can run on a worker thread: RTLIL is only read, under ThreadPool::kernelMutex(), to take
+			 *	a snapshot of the module (see ModToGraph::snapshotModule), and the messages are kept until flushBuildLog().
+			 *	A build that fails leaves an inconsistent Generator: the caller must check isConsistent().
+			 */
+			Generator(SubCircuit_v2::Graph& myg, RTLIL::Module *module, bool verbose=false, bool deferLog=false);
+
+			/*
+			 *	False if the graph could not be built or did not pass the checks; the build messages tell why.
+			 */
+			bool isConsistent() const { return this->consistent; }
+
+			/*
+			 *	Writes the messages kept back during a deferred build.
+			 */
+			void flushBuildLog();
 			
 			/*
 			 *	Given a signal, it returns all the slices sig[x:y] which appear as inputs in some ports.
@@ -212,13 +275,29 @@ namespace Generator
 			/*
 			 *	Find a correspondant among the coupledSignals. If getNew, we search for a forward renaming y such that x -> y, otherwise x <- y
 			 *	<newName , oldName>
+			 *	Names are interned ids (see Signal::internName), -1 if there is no renaming.
 			 */
-			std::string getRenaming(std::string signalName, bool getNew=true);
+			int getRenaming(int signalId, bool getNew=true);
 
 			/*
 			 *	Is the signal passed an external signal
 			 */
-			bool isExternalSignal_byNameOnly(Signal::Signal signal);
+			bool isExternalSignal_byNameOnly(const Signal::Signal &signal);
+
+			/*
+			 *	Is the signal passed the new name of a renaming, i.e. is it directly driven by a connection of the module (see coupledSignals)
+			 */
+			bool isCoupledSignal_byNameOnly(const Signal::Signal &signal);
+
+			/*
+			 *	Ports reading the signal with the given name id, whatever the slice (see SignalConsumer). Empty if the signal enters no port.
+			 */
+			const std::vector<SignalConsumer> &getSignalConsumers(int signalId);
+
+			/*
+			 *	Does the signal reach an inout port of the module (considered only in name)
+			 */
+			bool isInOutSignal_byNameOnly(const Signal::Signal &signal);
 			
 			/*
 			 *	Returns the list of nodes which receives as inputs signals coming from outside the current module.
@@ -237,7 +316,6 @@ namespace Generator
 
 			/*
 			 *	Method to transform the support structure in a string.
-			 *	std::vector< std::pair< Signal::Signal, std::vector<char> > >
 			 */
 			std::string condenseBit();
 			
@@ -247,21 +325,22 @@ namespace Generator
             bool isAtomic();
 
 			//Getters
-			std::string getModuleName();
-			SupportGraph::SupportGraph getSupportGraph();
-			std::vector<Signal::Signal> getEnteringSignals();
-			std::vector<Signal::Signal> getExitingSignals();
-			std::vector<Signal::Signal> getExternalSignals();
-			std::vector<std::pair< Signal::Signal, std::vector<char> > > getSliceStructure();
-			std::vector<std::pair<std::string, std::string> > getCoupledSignals();
-			std::vector<std::pair<Signal::Signal, Signal::Signal>> getPairedSignals();
-			std::vector<std::pair<std::string,std::string>> getInnerModules();
-			std::vector<Signal::Signal> getInoutSignals();
+			const std::string &getModuleName() const;
+			SupportGraph::SupportGraph& getSupportGraph();
+			const std::vector<Signal::Signal> &getEnteringSignals() const;
+			const std::vector<Signal::Signal> &getExitingSignals() const;
+			const std::vector<Signal::Signal> &getExternalSignals() const;
+			const SlicePlanes::SliceStructure &getSliceStructure() const;
+			SlicePlanes::SliceStructure &getSliceStructure();
+			const std::vector<std::pair<std::string, std::string> > &getCoupledSignals() const;
+			const std::vector<std::pair<Signal::Signal, Signal::Signal>> &getPairedSignals() const;
+			const std::vector<std::pair<std::string,std::string>> &getInnerModules() const;
+			const std::vector<Signal::Signal> &getInoutSignals() const;
             
             /*
              * Method used for instantiating the slice structure of the current module
              */
-			void setSliceStructure( std::vector< std::pair< Signal::Signal, std::vector<char> > > structure );
+			void setSliceStructure( SlicePlanes::SliceStructure structure );
 
 			//Classic toString method
             std::string toString();
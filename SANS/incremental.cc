@@ -0,0 +1,228 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Standard libraries
+#include <algorithm>
+#include <sstream>
+
+//Application libraries
+#include "incremental.h"
+
+Incremental::ResidentState::ResidentState(RTLIL::Design *design)
+{
+    this->design = design;
+    this->designIndex = design->hashidx_;
+    this->stale = true;
+
+    design->monitors.insert(this);
+}
+
+Incremental::ResidentState::~ResidentState()
+{
+    RTLIL::Design *alive = this->designAlive();
+
+    if(alive != nullptr)
+    {
+        alive->monitors.erase(this);
+    }
+}
+
+RTLIL::Design *Incremental::ResidentState::designAlive() const
+{
+    std::vector<RTLIL::Design *> designs(pushed_designs);
+    designs.push_back(yosys_design);
+
+    for(auto &saved : saved_designs)
+    {
+        designs.push_back(saved.second);
+    }
+
+    for(auto candidate : designs)
+    {
+        if(candidate != nullptr && this->isAttachedTo(candidate))
+        {
+            return candidate;
+        }
+    }
+
+    return nullptr;
+}
+
+bool Incremental::ResidentState::isAttachedTo(RTLIL::Design *design) const
+{
+    return this->design == design && this->designIndex == design->hashidx_;
+}
+
+void Incremental::ResidentState::release()
+{
+    this->stale = true;
+    this->dirtyModules.clear();
+    this->knownModules.clear();
+    this->entries.clear();
+    this->names.reset();
+}
+
+void Incremental::ResidentState::markDirty(RTLIL::Module *module)
+{
+    if(module != nullptr && !this->stale)
+    {
+        this->dirtyModules.insert(module->name.str());
+    }
+}
+
+void Incremental::ResidentState::notify_module_add(RTLIL::Module *module YS_ATTRIBUTE(unused))
+{
+    this->stale = true;
+}
+
+void Incremental::ResidentState::notify_module_del(RTLIL::Module *module YS_ATTRIBUTE(unused))
+{
+    this->stale = true;
+}
+
+void Incremental::ResidentState::notify_connect(RTLIL::Cell *cell, const RTLIL::IdString &port YS_ATTRIBUTE(unused), const RTLIL::SigSpec &old_sig YS_ATTRIBUTE(unused), RTLIL::SigSpec &sig YS_ATTRIBUTE(unused))
+{
+    this->markDirty(cell->module);
+}
+
+void Incremental::ResidentState::notify_connect(RTLIL::Module *module, const RTLIL::SigSig &sigsig YS_ATTRIBUTE(unused))
+{
+    this->markDirty(module);
+}
+
+void Incremental::ResidentState::notify_connect(RTLIL::Module *module, const std::vector<RTLIL::SigSig> &sigsig YS_ATTRIBUTE(unused))
+{
+    this->markDirty(module);
+}
+
+void Incremental::ResidentState::notify_blackout(RTLIL::Module *module)
+{
+    this->markDirty(module);
+}
+
+std::string Incremental::ResidentState::interfaceOf(RTLIL::Module *module)
+{
+    std::stringstream interface;
+
+    for(auto &portName : module->ports)
+    {
+        RTLIL::Wire *wire = module->wire(portName);
+
+        if(wire == nullptr)
+        {
+            continue;
+        }
+
+        interface << wire->port_id << ' ' << portName.str() << ' ' << wire->width << ' ' << wire->port_input << wire->port_output << '\n';
+    }
+
+    return interface.str();
+}
+
+std::string Incremental::ResidentState::shapeOf(RTLIL::Module *module)
+{
+    //Cell types and parameters, wire names and widths, memories and processes: everything the monitor is not told about
+    return AnalysisCache::AnalysisCache::hashContent(module);
+}
+
+void Incremental::ResidentState::beginRun(const std::vector<std::string> &moduleNames)
+{
+    std::vector<std::string> sorted(moduleNames);
+    std::sort(sorted.begin(), sorted.end());
+
+    if(sorted != this->knownModules)
+    {
+        this->stale = true;
+    }
+
+    if(this->stale)
+    {
+        this->entries.clear();
+        this->names.reset();
+    }
+
+    this->knownModules = sorted;
+}
+
+std::unique_ptr<AnalysisCache::CachedModule> Incremental::ResidentState::reuse(const std::string &moduleName, const std::string &interface, const std::string &shape) const
+{
+    if(this->stale || this->dirtyModules.count(moduleName) > 0)
+    {
+        return nullptr;
+    }
+
+    auto entry = this->entries.find(moduleName);
+
+    if(entry == this->entries.end() || entry->second.interface != interface || entry->second.shape != shape)
+    {
+        return nullptr;
+    }
+
+    return std::unique_ptr<AnalysisCache::CachedModule>(new AnalysisCache::CachedModule(entry->second.analysis));
+}
+
+bool Incremental::ResidentState::summaryChanged(const std::string &moduleName, const std::string &interface,
+                                                const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) const
+{
+    auto entry = this->entries.find(moduleName);
+
+    if(entry == this->entries.end())
+    {
+        return true;
+    }
+
+    return entry->second.interface != interface || entry->second.analysis.results != results;
+}
+
+void Incremental::ResidentState::record(const AnalysisCache::CachedModule &analysis, const std::string &interface, const std::string &shape)
+{
+    if(!this->names)
+    {
+        this->names.reset(new Signal::NameScope());
+    }
+
+    Entry &entry = this->entries[analysis.moduleName];
+
+    entry.analysis = analysis;
+    entry.interface = interface;
+    entry.shape = shape;
+}
+
+void Incremental::ResidentState::endRun(const std::set<std::string> &recorded)
+{
+    for(auto entry = this->entries.begin(); entry != this->entries.end(); )
+    {
+        if(recorded.count(entry->first) == 0)
+        {
+            entry = this->entries.erase(entry);
+        }
+        else
+        {
+            entry++;
+        }
+    }
+
+    if(this->entries.empty())
+    {
+        this->names.reset();
+    }
+
+    this->dirtyModules.clear();
+    this->stale = false;
+}
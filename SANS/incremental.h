@@ -0,0 +1,147 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+//Standard libraries
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+//Yosys library
+#include "kernel/yosys.h"
+
+//Application libraries
+#include "analysis_cache.h"
+
+USING_YOSYS_NAMESPACE
+
+namespace Incremental
+{
+    /*
+     *  Analysis state kept alive between two sans runs on the same design. It registers itself as an RTLIL::Monitor (the same hook used by
+     *  ModIndex) and marks dirty every module whose cells or connections are edited; the next run reanalyzes only the dirty modules and
+     *  those whose inner modules came out of their analysis with a different summary or interface, everything else keeps its last results.
+     *  Edits the kernel does not notify (cell types and parameters, new, removed, renamed or resized wires, memories, processes) are caught
+     *  by comparing the shape of each module, the hash of its content used by the analysis cache, with the one it had in the last run.
+     *  Adding, removing or renaming a module changes which cells are module placeholders: the whole design is analyzed again.
+     */
+    class ResidentState : public RTLIL::Monitor
+    {
+        private:
+            struct Entry
+            {
+                AnalysisCache::CachedModule analysis;
+                std::string interface;
+                std::string shape;
+            };
+
+            //The state is only ever used with the design it was created for, hashidx_ tells a new design allocated at the same address
+            RTLIL::Design *design;
+            unsigned int designIndex;
+
+            //Nothing from the last run can be reused: first run, or the set of modules changed
+            bool stale;
+            std::set<std::string> dirtyModules;
+            //Names of the modules seen by the last run, sorted
+            std::vector<std::string> knownModules;
+            //Module name -> analysis of the last run
+            std::map<std::string, Entry> entries;
+            //Keeps the signal names of the stored results alive between runs, only while there are entries
+            std::unique_ptr<Signal::NameScope> names;
+
+            void markDirty(RTLIL::Module *module);
+
+            /*
+             *  The design of the state, if Yosys still holds it (current, pushed or saved design). Only those are dereferenced: the one the
+             *  state was created for may have been deleted already.
+             */
+            RTLIL::Design *designAlive() const;
+
+        public:
+            /*
+             *  Registers the state among the monitors of the design.
+             */
+            ResidentState(RTLIL::Design *design);
+
+            /*
+             *  Leaves the monitors of the design, if the design is still alive (see designAlive).
+             */
+            ~ResidentState();
+
+            ResidentState(const ResidentState &) = delete;
+            ResidentState &operator=(const ResidentState &) = delete;
+
+            bool isAttachedTo(RTLIL::Design *design) const;
+
+            /*
+             *  Drops the stored results, to free them while the design is not analyzed. The state keeps monitoring: the next run starts over.
+             */
+            void release();
+
+            //RTLIL::Monitor notifications
+            void notify_module_add(RTLIL::Module *module) YS_OVERRIDE;
+            void notify_module_del(RTLIL::Module *module) YS_OVERRIDE;
+            void notify_connect(RTLIL::Cell *cell, const RTLIL::IdString &port, const RTLIL::SigSpec &old_sig, RTLIL::SigSpec &sig) YS_OVERRIDE;
+            void notify_connect(RTLIL::Module *module, const RTLIL::SigSig &sigsig) YS_OVERRIDE;
+            void notify_connect(RTLIL::Module *module, const std::vector<RTLIL::SigSig> &sigsig) YS_OVERRIDE;
+            void notify_blackout(RTLIL::Module *module) YS_OVERRIDE;
+
+            /*
+             *  Ports of the module as seen by its instances (order, name, width and direction), and a fingerprint of its content (see
+             *  AnalysisCache::hashContent).
+             *  Both read the design: call them while holding the kernel.
+             */
+            static std::string interfaceOf(RTLIL::Module *module);
+            static std::string shapeOf(RTLIL::Module *module);
+
+            /*
+             *  Starts a run over the given modules: if they are not the ones of the last run, every stored result is dropped.
+             */
+            void beginRun(const std::vector<std::string> &moduleNames);
+
+            /*
+             *  Last analysis of the module if it has not been edited since then, nullptr otherwise. It is still valid only if none of its
+             *  inner modules changes summary (see summaryChanged).
+             */
+            std::unique_ptr<AnalysisCache::CachedModule> reuse(const std::string &moduleName, const std::string &interface, const std::string &shape) const;
+
+            /*
+             *  Whether the modules instantiating this one could see it differently than in the last run: its interface or its results changed.
+             *  Only reads the stored entries, safe to call from the workers of a run.
+             */
+            bool summaryChanged(const std::string &moduleName, const std::string &interface,
+                                const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) const;
+
+            /*
+             *  Stores the analysis of a module for the next run.
+             */
+            void record(const AnalysisCache::CachedModule &analysis, const std::string &interface, const std::string &shape);
+
+            /*
+             *  Closes the run: the modules not recorded are analyzed again next time, every module is clean.
+             */
+            void endRun(const std::set<std::string> &recorded);
+    };
+}
+
+#endif
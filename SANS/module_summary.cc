@@ -0,0 +1,116 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Application libraries
+#include "module_summary.h"
+#include "profiler.h"
+
+ModuleSummary::ModuleSummaryStore::ModuleSummaryStore(const std::vector<Generator::Generator *> &modules, const std::vector<std::string> &moduleNames)
+    : modules(modules), moduleNames(moduleNames), summaries(moduleNames.size())
+{
+    for(int i = 0; i < (int)this->moduleNames.size(); i++)
+    {
+        this->moduleIndex.insert(std::make_pair(this->moduleNames[i], i));
+    }
+}
+
+const std::vector<Generator::Generator *> &ModuleSummary::ModuleSummaryStore::getModules() const { return this->modules; }
+Generator::Generator *ModuleSummary::ModuleSummaryStore::getModule(int module) const { return this->modules[module]; }
+const std::string &ModuleSummary::ModuleSummaryStore::getModuleName(int module) const { return this->moduleNames[module]; }
+
+int ModuleSummary::ModuleSummaryStore::findModuleIndex(const std::string &name) const
+{
+    auto it = this->moduleIndex.find(name);
+
+    return it != this->moduleIndex.end() ? it->second : -1;
+}
+
+const ModuleSummary::ModuleSummaryStore::Summary *ModuleSummary::ModuleSummaryStore::findSummary(int module) const
+{
+    std::lock_guard<std::mutex> guard(this->summariesLock);
+
+    return this->summaries[module].get();
+}
+
+bool ModuleSummary::ModuleSummaryStore::publish(int module, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > results,
+                                                SlicePlanes::SliceStructure sliceStructure)
+{
+    //The summary is completed before it becomes visible
+    std::unique_ptr<Summary> summary(new Summary());
+
+    for(auto &result : results)
+    {
+        int role = (result.second.first ? DATA_ROLE : NO_ROLE) | (result.second.second ? SELECT_ROLE : NO_ROLE);
+        summary->portRoles.insert(std::make_pair(result.first.getSignalId(), role));
+    }
+
+    summary->results = std::move(results);
+    summary->sliceStructure = std::move(sliceStructure);
+
+    std::lock_guard<std::mutex> guard(this->summariesLock);
+
+    if(this->summaries[module] != nullptr)
+    {
+        return false;
+    }
+
+    this->summaries[module] = std::move(summary);
+    return true;
+}
+
+bool ModuleSummary::ModuleSummaryStore::isSummarized(int module) const
+{
+    return this->findSummary(module) != nullptr;
+}
+
+int ModuleSummary::ModuleSummaryStore::getPortRole(int module, int portNameId) const
+{
+    const Summary *summary = this->findSummary(module);
+
+    if(summary == nullptr)
+    {
+        Profiler::count(Profiler::COUNTER_SUMMARY_MISSES, 1);
+        return -1;
+    }
+
+    auto it = summary->portRoles.find(portNameId);
+
+    if(it == summary->portRoles.end())
+    {
+        Profiler::count(Profiler::COUNTER_SUMMARY_MISSES, 1);
+        return NO_ROLE;
+    }
+
+    Profiler::count(Profiler::COUNTER_SUMMARY_HITS, 1);
+    return it->second;
+}
+
+const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > *ModuleSummary::ModuleSummaryStore::getResults(int module) const
+{
+    const Summary *summary = this->findSummary(module);
+
+    return summary != nullptr ? &summary->results : nullptr;
+}
+
+const SlicePlanes::SliceStructure *ModuleSummary::ModuleSummaryStore::getSliceStructure(int module) const
+{
+    const Summary *summary = this->findSummary(module);
+
+    return summary != nullptr ? &summary->sliceStructure : nullptr;
+}
@@ -0,0 +1,116 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef MODULE_SUMMARY_H
+#define MODULE_SUMMARY_H
+
+//Standard libraries
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//Application libraries
+#include "generator_library.h"
+
+namespace ModuleSummary
+{
+    /*
+     *  Bits of the role of a module port, as seen from the modules that instantiate it.
+     */
+    enum PortRole
+    {
+        NO_ROLE = 0,
+        DATA_ROLE = 1,
+        SELECT_ROLE = 2
+    };
+
+    /*
+     *  Design-wide store of the analysis results, shared by the DesignAnalyzer and by every DFS of a run. Each module is summarized once:
+     *  its DFS_FTSA results, its slice structure and, indexed by port name id, the role bitmask of each of its ports. Modules are addressed
+     *  by their position in the design and indexed by name; a module answered by the analysis cache has a summary but no Generator.
+     *  A summary never changes once published, so readers only take the lock to find it.
+     */
+    class ModuleSummaryStore
+    {
+        private:
+            struct Summary
+            {
+                std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > results;
+                SlicePlanes::SliceStructure sliceStructure;
+                //Port name id -> PortRole bits
+                std::unordered_map<int, int> portRoles;
+            };
+
+            //Modules of the design, in design order (nullptr for the ones without a Generator), and their names
+            std::vector<Generator::Generator *> modules;
+            std::vector<std::string> moduleNames;
+            //Module name -> position in modules. Filled by the constructor, read-only afterwards
+            std::unordered_map<std::string, int> moduleIndex;
+
+            //Guards summaries, not the Summary objects
+            mutable std::mutex summariesLock;
+            std::vector< std::unique_ptr<Summary> > summaries;
+
+            const Summary *findSummary(int module) const;
+
+        public:
+            ModuleSummaryStore(const std::vector<Generator::Generator *> &modules, const std::vector<std::string> &moduleNames);
+
+            ModuleSummaryStore(const ModuleSummaryStore &) = delete;
+            ModuleSummaryStore &operator=(const ModuleSummaryStore &) = delete;
+
+            const std::vector<Generator::Generator *> &getModules() const;
+
+            /*
+             *  Position of the module called name in getModules(), -1 if there is none. With repeated names the first module wins.
+             */
+            int findModuleIndex(const std::string &name) const;
+
+            /*
+             *  Generator of the module in position module, nullptr if it has none.
+             */
+            Generator::Generator *getModule(int module) const;
+            const std::string &getModuleName(int module) const;
+
+            /*
+             *  Stores the DFS_FTSA results and the slice structure of a module. The role of a port is taken from the first result carrying its
+             *  name. Returns false (and keeps the old summary) if the module had already been published.
+             */
+            bool publish(int module, std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > results,
+                         SlicePlanes::SliceStructure sliceStructure);
+
+            bool isSummarized(int module) const;
+
+            /*
+             *  PortRole bits of a port of the module: NO_ROLE for unknown ports, -1 if the module has not been published yet.
+             */
+            int getPortRole(int module, int portNameId) const;
+
+            /*
+             *  Results and slice structure published for the module, nullptr if it has not been published yet. They stay valid as long as the store does.
+             */
+            const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > *getResults(int module) const;
+            const SlicePlanes::SliceStructure *getSliceStructure(int module) const;
+    };
+}
+
+#endif
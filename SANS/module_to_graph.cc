@@ -17,91 +17,181 @@
  *
  */
 
+#include "rtlil_dumper.h"
 #include "module_to_graph.h"
 
+namespace
+{
+	ModToGraph::PortSnapshot portOf(RTLIL::Wire *wire)
+	{
+		ModToGraph::PortSnapshot port;
+		port.name = wire->name.str();
+		port.width = wire->width;
+		port.portId = wire->port_id;
+		port.input = wire->port_input;
+		port.output = wire->port_output;
+
+		return port;
+	}
+}
+
+ModToGraph::ModuleSnapshot ModToGraph::snapshotModule(RTLIL::Module *mod)
+{
+	ModuleSnapshot snapshot;
+	snapshot.name = mod->name.str();
+
+	SigMap sigmap(mod);
+	dict<RTLIL::SigBit, int> bitIds;
+
+	auto number = [&](const RTLIL::SigBit &bit) -> int
+	{
+		if (bit.wire == NULL)
+		{
+			return -1 - int(bit.data);
+		}
+
+		auto it = bitIds.find(bit);
+		if (it != bitIds.end())
+		{
+			return it->second;
+		}
+
+		int id = snapshot.bitCount++;
+		bitIds[bit] = id;
+		return id;
+	};
+
+	for ( auto &cell_it : mod->cells_ )
+	{
+		RTLIL::Cell *cell = cell_it.second;
+
+		snapshot.cells.push_back(CellSnapshot());
+		CellSnapshot &cellSnapshot = snapshot.cells.back();
+		cellSnapshot.name = cell->name.str();
+		cellSnapshot.type = cell->type.str();
+
+		//Cells standing for another module of the design need its ports
+		RTLIL::Module *instantiated = mod->design != nullptr ? mod->design->module(cell->type) : nullptr;
+
+		if (instantiated != nullptr && snapshot.instantiated.count(cellSnapshot.type) == 0)
+		{
+			std::vector<PortSnapshot> &ports = snapshot.instantiated[cellSnapshot.type];
+
+			for (auto wire : instantiated->wires())
+			{
+				if (wire->port_id > 0)
+				{
+					ports.push_back(portOf(wire));
+				}
+			}
+		}
+
+		for ( auto &conn : cell->connections() )
+		{
+			cellSnapshot.connections.push_back(ConnectionSnapshot());
+			ConnectionSnapshot &connection = cellSnapshot.connections.back();
+			connection.port = conn.first.str();
+			connection.input = cell->input(conn.first);
+			connection.output = cell->output(conn.first);
+			connection.isWire = conn.second.is_wire();
+			connection.signals = RTLIL_DUMPER::sigSpecDumper(conn.second);
+
+			RTLIL::SigSpec conn_sig = sigmap(conn.second);
+			connection.realSignals = RTLIL_DUMPER::portSignalDumper(conn_sig);
+
+			for (auto &bit : conn_sig)
+			{
+				connection.bits.push_back(number(bit));
+			}
+		}
+	}
+
+	for ( auto &wire_it : mod->wires_ )
+	{
+		RTLIL::Wire *wire = wire_it.second;
+
+		if (wire->port_id > 0)
+		{
+			snapshot.ports.push_back(portOf(wire));
+
+			for (auto &bit : sigmap(RTLIL::SigSpec(wire)))
+			{
+				snapshot.ports.back().bits.push_back(number(bit));
+			}
+		}
+	}
+
+	for ( auto &conn : mod->connections() )
+	{
+		snapshot.connections.push_back(RTLIL_DUMPER::connDumper(conn.first, conn.second));
+	}
+
+	for ( auto &it : mod->memories )
+	{
+		snapshot.memories.push_back(it.second->name.str());
+	}
+
+	return snapshot;
+}
+
 /*
  *	Method belonging to the SubCircuit library. We include it here with slight modifications to be able to build the whole project as a Yosys' integrable module.
  *	Otherwise, each person that needs our functionalities will need to recompile Yosys, and like no, thanks..
  */
-std::vector< std::pair< std::string, int > > ModToGraph::mod2graph(SubCircuit_v2::Graph &graph, RTLIL::Module *mod)
+void ModToGraph::mod2graph(SubCircuit_v2::Graph &graph, const ModuleSnapshot &mod)
 {
-	std::vector< std::pair<std::string,int> > externalSignals;
-	std::map<RTLIL::SigBit, bit_ref_t> sig_bit_ref;
-	std::map<std::pair<RTLIL::Wire*, int>, int> sig_use_count;
+	std::vector<bit_ref_t> sig_bit_ref(mod.bitCount);
 
-	SigMap sigmap(mod);
-	
 	//Take each module's cell
-	for ( auto &cell_it : mod->cells_ )
+	for ( auto &cell : mod.cells )
 	{
-		RTLIL::Cell *cell = cell_it.second;
-		
-		std::string type = cell->type.str();
-		
+		std::string type = cell.type;
+
 		if (type.substr(0, 2) == "\\$")
 		{
 			type = type.substr(1);
 		}
-		
+
 		//Create a node of the graph
-		graph.createNode(cell->name.str(), type, (void*)cell);
-		
-		for ( auto &conn : cell->connections() )
+		graph.createNode(cell.name, type, (void*)&cell);
+
+		for ( auto &conn : cell.connections )
 		{
-			graph.createPort(cell->name.str(), conn.first.str(), conn.second.size());
-			
-			RTLIL::SigSpec conn_sig = conn.second;
-			sigmap.apply(conn_sig);
+			graph.createPort(cell.name, conn.port, (int)conn.bits.size());
 
-			for (int i = 0; i < conn_sig.size(); i++)
+			for (int i = 0; i < (int)conn.bits.size(); i++)
 			{
-				auto &bit = conn_sig[i];
-				if (bit.wire == NULL)
+				int bit = conn.bits[i];
+
+				if (bit < 0)
 				{
-					graph.createConstant(cell->name.str(), conn.first.str(), i, int(bit.data));
+					graph.createConstant(cell.name, conn.port, i, -1 - bit);
 					continue;
 				}
 
-				if (sig_bit_ref.count(bit) == 0)
+				bit_ref_t &bit_ref = sig_bit_ref[bit];
+				if (bit_ref.cell == nullptr)
 				{
-					bit_ref_t &bit_ref = sig_bit_ref[bit];
-					bit_ref.cell = cell->name.str();
-					bit_ref.port = conn.first.str();
+					bit_ref.cell = &cell.name;
+					bit_ref.port = &conn.port;
 					bit_ref.bit = i;
 				}
-				bit_ref_t &bit_ref = sig_bit_ref[bit];
-				graph.createConnection(bit_ref.cell, bit_ref.port, bit_ref.bit, cell->name.str(), conn.first.str(), i);
+
+				graph.createConnection(*bit_ref.cell, *bit_ref.port, bit_ref.bit, cell.name, conn.port, i);
 			}
 		}
 	}
 
 	//Mark external signals (used in module ports)
-	for ( auto &wire_it : mod->wires_ )
+	for ( auto &port : mod.ports )
 	{
-		RTLIL::Wire *wire = wire_it.second;
-		if (wire->port_id > 0)
+		for (int bit : port.bits)
 		{
-			externalSignals.push_back( std::make_pair(wire->name.str(), wire->width ) );
-			
-			RTLIL::SigSpec conn_sig(wire);
-			sigmap.apply(conn_sig);
-			
-			for (auto &bit : conn_sig)
+			if (bit >= 0 && sig_bit_ref[bit].cell != nullptr)
 			{
-				if (sig_bit_ref.count(bit) != 0)
-				{
-					bit_ref_t &bit_ref = sig_bit_ref[bit];
-					graph.markExtern(bit_ref.cell, bit_ref.port, bit_ref.bit);
-				}
+				bit_ref_t &bit_ref = sig_bit_ref[bit];
+				graph.markExtern(*bit_ref.cell, *bit_ref.port, bit_ref.bit);
 			}
 		}
 	}
-	
-	/*if(verbose)
-	{
-		graph.print();
-	}
-	//*/
-
-	return externalSignals;
 }
@@ -26,25 +26,91 @@
 #include "kernel/sigtools.h"
 #include "backends/ilang/ilang_backend.h"
 
+#include "signal_library.h"
+
 USING_YOSYS_NAMESPACE
 
 namespace ModToGraph
 {
 	/*
-	 *	Support structure for the mod2gr function.
+	 *	Support structure for the mod2gr function: first port bit met on a wire bit.
 	 */
 	struct bit_ref_t
 	{
-		std::string cell;
+		const std::string *cell = nullptr;
+		const std::string *port = nullptr;
+		int bit = -1;
+	};
+
+	/*
+	 *	A connection of a cell, as read from RTLIL.
+	 */
+	struct ConnectionSnapshot
+	{
 		std::string port;
-		int bit;
+		//cell->input() and cell->output() of the port
+		bool input = false;
+		bool output = false;
+		//The connection is a whole wire
+		bool isWire = false;
+		//Bits after the SigMap: wire bits are numbered from 0 across the module, a constant bit of value v is stored as -1 - v
+		std::vector<int> bits;
+		//RTLIL_DUMPER::sigSpecDumper of the connection, and RTLIL_DUMPER::portSignalDumper of its SigMap
+		std::pair<bool, std::vector<Signal::Signal>> signals;
+		std::vector<Signal::Signal> realSignals;
+	};
+
+	struct CellSnapshot
+	{
+		std::string name;
+		std::string type;
+		std::vector<ConnectionSnapshot> connections;
+	};
+
+	/*
+	 *	A port wire of a module.
+	 */
+	struct PortSnapshot
+	{
+		std::string name;
+		int width = 0;
+		int portId = 0;
+		bool input = false;
+		bool output = false;
+		//Bits after the SigMap, numbered as in ConnectionSnapshot (only for the ports of the module itself)
+		std::vector<int> bits;
 	};
 
+	/*
+	 *	Everything the build of a Generator reads from an RTLIL::Module. It is taken under ThreadPool::kernelMutex(); the graphs are then
+	 *	built from it without the lock, since past this point no IdString, SigSpec or hashlib table of the kernel is touched.
+	 */
+	struct ModuleSnapshot
+	{
+		std::string name;
+		std::vector<CellSnapshot> cells;
+		//Wires with a port_id, in the order of the module
+		std::vector<PortSnapshot> ports;
+		//Number of distinct wire bits in cells and ports
+		int bitCount = 0;
+		//RTLIL_DUMPER::connDumper of each connection of the module
+		std::vector< std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> > connections;
+		std::vector<std::string> memories;
+		//Port wires of the modules of the design instantiated here, by module name
+		std::map< std::string, std::vector<PortSnapshot> > instantiated;
+	};
+
+	/*
+	 *	Copies out of mod what the build of its Generator needs. The caller must hold ThreadPool::kernelMutex().
+	 */
+	ModuleSnapshot snapshotModule(RTLIL::Module *mod);
+
 	/*
 	 *	Method belonging to the SubCircuit library. We include it here with slight modifications to be able to build the whole project as a Yosys' integrable module.
 	 *	Otherwise, each person that needs our functionalities will need to recompile Yosys, and like no, thanks..
+	 *	It works on a snapshot of the module, so it does not need the kernel lock. Node user data points to the CellSnapshot of the node.
 	 */
-	std::vector< std::pair< std::string, int > > mod2graph(SubCircuit_v2::Graph &graph, RTLIL::Module *mod);
+	void mod2graph(SubCircuit_v2::Graph &graph, const ModuleSnapshot &mod);
 }
 
-#endif
\ No newline at end of file
+#endif
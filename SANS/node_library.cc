@@ -19,11 +19,11 @@
 
 #include "node_library.h"
 
-Graph_Node::Node::Node(int nodeId, std::string nodeName, std::string nodeType, bool modulePlaceholder) : nodeId(nodeId), name(nodeName), type(nodeType), modulePlaceholder(modulePlaceholder) {}
+Graph_Node::Node::Node(int nodeId, std::string nodeName, std::string nodeType, bool modulePlaceholder) : nodeId(nodeId), name(std::move(nodeName)), type(std::move(nodeType)), modulePlaceholder(modulePlaceholder) {}
 
-int Graph_Node::Node::getId() { return this->nodeId; }
-std::string Graph_Node::Node::getName() { return this->name; }
-std::string Graph_Node::Node::getType() { return this->type; }
+int Graph_Node::Node::getId() const { return this->nodeId; }
+const std::string &Graph_Node::Node::getName() const { return this->name; }
+const std::string &Graph_Node::Node::getType() const { return this->type; }
 
 bool Graph_Node::Node::isEmitter()
 {
@@ -38,34 +38,24 @@ bool Graph_Node::Node::isEmitter()
 	return false;
 }
 
-bool Graph_Node::Node::isModulePlaceholder()
+bool Graph_Node::Node::isModulePlaceholder() const
 {
 	return this->modulePlaceholder;
 }
 
-std::vector<Graph_Port::Port *> Graph_Node::Node::getInputs()
+const std::vector<Graph_Port::Port *> &Graph_Node::Node::getInputs() const
 {
-	std::vector<Graph_Port::Port *> temp;
-	temp = VectorSupport::merge( temp, inputPorts );
-	temp = VectorSupport::merge( temp, inoutPorts );
-	return temp;
+	return this->inputsView;
 }
 
-std::vector<Graph_Port::Port *> Graph_Node::Node::getOutputs()
+const std::vector<Graph_Port::Port *> &Graph_Node::Node::getOutputs() const
 {
-	std::vector<Graph_Port::Port *> temp;
-	temp = VectorSupport::merge( temp, outputPorts );
-	temp = VectorSupport::merge( temp, inoutPorts );
-	return temp;
+	return this->outputsView;
 }
 
-std::vector<Graph_Port::Port *> Graph_Node::Node::getPorts()
+const std::vector<Graph_Port::Port *> &Graph_Node::Node::getPorts() const
 {
-	std::vector<Graph_Port::Port *> temp;
-	temp = VectorSupport::merge( temp, inputPorts );
-	temp = VectorSupport::merge( temp, outputPorts );
-	temp = VectorSupport::merge( temp, inoutPorts );
-	return temp;
+	return this->portsView;
 }
 
 Graph_Port::Port* Graph_Node::Node::getPort(int id)
@@ -78,8 +68,9 @@ Graph_Port::Port* Graph_Node::Node::getPort(int id)
 		}
 	}
 
-	Graph_Port::Port* errorPort = new Graph_Port::Port("Error_Port");
-	return errorPort;
+	//Shared by all the nodes, never modified: its direction is INVALID
+	static Graph_Port::Port errorPort("Error_Port");
+	return &errorPort;
 }
 
 int Graph_Node::Node::addPort(Graph_Port::Port *newPort, Graph_Port::PortDirection direction)
@@ -120,6 +111,18 @@ int Graph_Node::Node::addPort(Graph_Port::Port *newPort, Graph_Port::PortDirecti
 			std::cout << "Geeettttttt dunked on!!!" << std::endl;
 			return -4;
 	}
+
+	//Views keep the order of the lists: inputs, outputs, inouts
+	this->inputsView = this->inputPorts;
+	this->inputsView.insert(this->inputsView.end(), this->inoutPorts.begin(), this->inoutPorts.end());
+
+	this->outputsView = this->outputPorts;
+	this->outputsView.insert(this->outputsView.end(), this->inoutPorts.begin(), this->inoutPorts.end());
+
+	this->portsView = this->inputPorts;
+	this->portsView.insert(this->portsView.end(), this->outputPorts.begin(), this->outputPorts.end());
+	this->portsView.insert(this->portsView.end(), this->inoutPorts.begin(), this->inoutPorts.end());
+
 	return 1;
 }
 
@@ -178,7 +181,7 @@ bool Graph_Node::Node::setModulePort(Graph_Port::Port *newPort,bool data,bool se
   * In case of a module_placeholder, we used this method for 
   * getting the selection ports
 */
-std::vector<Graph_Port::Port *> Graph_Node::Node::getModuleSelectionPorts()
+const std::vector<Graph_Port::Port *> &Graph_Node::Node::getModuleSelectionPorts() const
 {
     return this->moduleSelectionPorts;
 }
@@ -187,7 +190,7 @@ std::vector<Graph_Port::Port *> Graph_Node::Node::getModuleSelectionPorts()
  * In case of a module_placeholder, we used this method for 
  * getting the data ports
 */
-std::vector<Graph_Port::Port *> Graph_Node::Node::getModuleDataPorts()
+const std::vector<Graph_Port::Port *> &Graph_Node::Node::getModuleDataPorts() const
 {
     return this->moduleDataPorts;
 }
@@ -50,14 +50,19 @@ namespace Graph_Node
             std::vector<Graph_Port::Port *> moduleDataPorts;
             std::vector<Graph_Port::Port *> moduleSelectionPorts;
 
+			//Views over the port lists (inputs + inouts, outputs + inouts, all of them), kept up to date by addPort
+			std::vector<Graph_Port::Port *> inputsView;
+			std::vector<Graph_Port::Port *> outputsView;
+			std::vector<Graph_Port::Port *> portsView;
+
 		public:
 			//Constructor
 			Node(int nodeId, std::string nodeName, std::string nodeType, bool modulePlaceholder = false);
 			
-			//Getters
-			int getId();
-			std::string getName();
-			std::string getType();
+			//Getters. Containers are returned by reference: they stay valid as long as the node does.
+			int getId() const;
+			const std::string &getName() const;
+			const std::string &getType() const;
 			/*
 			 *	The node is a signal emitter if at least one of its outputs (output/inout ports) is connected to extern
 			 */
@@ -66,22 +71,22 @@ namespace Graph_Node
 			/*
 			 * Method used to state if a node is a module placeholder (i.e. the cell is not an atomic cell but must be considered as a blackbox)
 			 */
-			bool isModulePlaceholder();
+			bool isModulePlaceholder() const;
 			
 			/*
 			 *	This method is the one suggested when searching for input ports since it considers the inout possibility too.
 			 */
-			std::vector<Graph_Port::Port *> getInputs();
+			const std::vector<Graph_Port::Port *> &getInputs() const;
 
 			/*
 			 *	This method is the one suggsted when searching for output ports since it considers the inout possibility too.
 			 */
-			std::vector<Graph_Port::Port *> getOutputs();
+			const std::vector<Graph_Port::Port *> &getOutputs() const;
 
 			/*
 			 *	This method returns all the ports. Used solely for debug purpose.
 			 */
-			std::vector<Graph_Port::Port *> getPorts();
+			const std::vector<Graph_Port::Port *> &getPorts() const;
 
 			/*
 			 *	Get port form its id.
@@ -114,13 +119,13 @@ namespace Graph_Node
              * In case of a module_placeholder, we used this method for 
              * getting the selection ports
              */
-            std::vector<Graph_Port::Port *> getModuleSelectionPorts();
+            const std::vector<Graph_Port::Port *> &getModuleSelectionPorts() const;
             
              /**
              * In case of a module_placeholder, we used this method for 
              * getting the data ports
              */
-            std::vector<Graph_Port::Port *> getModuleDataPorts();
+            const std::vector<Graph_Port::Port *> &getModuleDataPorts() const;
             
              /**
              * In case of a module_placeholder, we used this method for 
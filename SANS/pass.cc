@@ -44,11 +44,17 @@
 #include "generator_library.h"
 #include "stdio_support.h"
 #include "design_analyzer.h"
+#include "incremental.h"
+#include "result_writer.h"
+#include "profiler.h"
+#include "trace.h"
 
 #define FILE_TXT "./OUTPUT/sans.txt"
 #define FILE_XML "./OUTPUT/sans.xml"
 #define FILE_JSON "./OUTPUT/sans.json"
 #define FILE_CSV "./OUTPUT/sans.csv"
+#define FILE_NDJSON "./OUTPUT/sans.ndjson"
+#define FILE_PROFILE "./OUTPUT/sans_profile.json"
 
 USING_YOSYS_NAMESPACE
 
@@ -63,11 +69,53 @@ struct flags
     bool print_XML = false;
     bool print_JSON = false;
     bool print_CSV = false;
+    bool print_NDJSON = false;
+    std::string binaryFile = "";
+    bool componentReachability = true;
+    bool laneSweep = false;
+    bool conePruning = true;
+    int threads = 0;
+    std::string cacheDirectory = "";
+    bool incremental = false;
+    bool profile = false;
+    std::string traceFile = "";
 } current_execution_flags;
 
 struct SignalAnalyzer : public Pass
 {
     private:
+        //States kept between incremental runs, one per design. They stay registered as monitors: they live as long as the pass does
+        std::map<RTLIL::Design *, std::unique_ptr<Incremental::ResidentState>> residentStates;
+
+        /*
+         *  Resident state of the design, created at its first incremental run. The states of the other designs drop their results.
+         */
+        Incremental::ResidentState *residentState(RTLIL::Design *design)
+        {
+            auto found = residentStates.find(design);
+
+            //Same address, different design: the old one has been deleted, together with its list of monitors
+            if(found != residentStates.end() && !found->second->isAttachedTo(design))
+            {
+                residentStates.erase(found);
+                found = residentStates.end();
+            }
+
+            for(auto &state : residentStates)
+            {
+                if(state.first != design)
+                {
+                    state.second->release();
+                }
+            }
+
+            if(found == residentStates.end())
+            {
+                found = residentStates.emplace(design, std::unique_ptr<Incremental::ResidentState>(new Incremental::ResidentState(design))).first;
+            }
+
+            return found->second.get();
+        }
         
         /*
          *  Handle allowed CMD options. Returns number of options.
@@ -76,6 +124,9 @@ struct SignalAnalyzer : public Pass
         {
             size_t argidx = 0;
 
+            //The flags outlive the command: every sans invocation starts again from the defaults
+            current_execution_flags = flags();
+
             for (argidx = 1; argidx < args.size(); argidx++)
             {
                 if (args[argidx] == "-condense") {
@@ -102,10 +153,50 @@ struct SignalAnalyzer : public Pass
                     current_execution_flags.print_JSON = true;
                     continue;
                 }
+                if (args[argidx] == "-ndjson") {
+                    current_execution_flags.print_NDJSON = true;
+                    continue;
+                }
                 if (args[argidx] == "-csv") {
                     current_execution_flags.print_CSV = true;
                     continue;
                 }
+                if (args[argidx] == "-bin" && argidx+1 < args.size()) {
+                    current_execution_flags.binaryFile = args[++argidx];
+                    continue;
+                }
+                if (args[argidx] == "-noscc") {
+                    current_execution_flags.componentReachability = false;
+                    continue;
+                }
+                if (args[argidx] == "-lanes") {
+                    current_execution_flags.laneSweep = true;
+                    continue;
+                }
+                if (args[argidx] == "-noprune") {
+                    current_execution_flags.conePruning = false;
+                    continue;
+                }
+                if (args[argidx] == "-threads" && argidx+1 < args.size()) {
+                    current_execution_flags.threads = atoi(args[++argidx].c_str());
+                    continue;
+                }
+                if (args[argidx] == "-cache" && argidx+1 < args.size()) {
+                    current_execution_flags.cacheDirectory = args[++argidx];
+                    continue;
+                }
+                if (args[argidx] == "-incremental") {
+                    current_execution_flags.incremental = true;
+                    continue;
+                }
+                if (args[argidx] == "-profile") {
+                    current_execution_flags.profile = true;
+                    continue;
+                }
+                if (args[argidx] == "-trace" && argidx+1 < args.size()) {
+                    current_execution_flags.traceFile = args[++argidx];
+                    continue;
+                }
                 break;
             }
 
@@ -115,37 +206,63 @@ struct SignalAnalyzer : public Pass
         }
 
         /*
-         *  Following the specified options, output all the requested stuff.
+         *  Following the specified options, creates the writers of all the requested outputs.
          */
-        void outputResults(DesignAnalyzer::Final_Results frf)
+        std::vector<std::unique_ptr<ResultWriter::ResultWriter>> createWriters()
         {
+            std::vector<std::unique_ptr<ResultWriter::ResultWriter>> writers;
+            bool condense = current_execution_flags.condenseResults;
+
             if( current_execution_flags.print_STDOUT || current_execution_flags.print_PLAINTEXT )
             {
-                std::cout << frf.plaintext << std::endl;
+                writers.emplace_back(new ResultWriter::PlaintextWriter(std::cout, condense));
             }
 
             if( current_execution_flags.print_PLAINTEXT )
             {
                 //Write plaintext file
-                IOSupport::writeResultToCleanFile(FILE_TXT, frf.plaintext);
+                writers.emplace_back(new ResultWriter::PlaintextWriter(FILE_TXT, condense));
             }
+
             if( current_execution_flags.print_XML )
             {
                 //Write xml file
-                IOSupport::writeResultToCleanFile(FILE_XML, frf.xml);
+                writers.emplace_back(new ResultWriter::XMLWriter(FILE_XML, condense));
             }
 
             if( current_execution_flags.print_JSON )
             {
                 //Write json file
-                IOSupport::writeResultToCleanFile(FILE_JSON, frf.json);
+                writers.emplace_back(new ResultWriter::JSONWriter(FILE_JSON, condense));
+            }
+
+            if( current_execution_flags.print_NDJSON )
+            {
+                //Write ndjson file, a record per signal
+                writers.emplace_back(new ResultWriter::NDJSONWriter(FILE_NDJSON, condense));
             }
 
             if( current_execution_flags.print_CSV )
             {
                 //Write csv file
-                IOSupport::writeResultToCleanFile(FILE_CSV, frf.csv);
+                writers.emplace_back(new ResultWriter::CSVWriter(FILE_CSV, condense));
+            }
+
+            if( !current_execution_flags.binaryFile.empty() )
+            {
+                //Write binary columnar file
+                writers.emplace_back(new ResultWriter::BinaryWriter(current_execution_flags.binaryFile, condense));
             }
+
+            for(auto &writer : writers)
+            {
+                if(!writer->isOpen())
+                {
+                    log_warning("Cannot open one of the output files (the textual ones go in the ./OUTPUT directory).\n");
+                }
+            }
+
+            return writers;
         }
     
     public:
@@ -159,27 +276,83 @@ struct SignalAnalyzer : public Pass
             //CMD Support
             cmd_args(args, design);
 
-            //This must be a singleton. It's not implemented like that in our project though. If future releases need two of this, be careful with files handling.
-			DesignAnalyzer::DesignAnalyzer dAnalyzer(design);
+            //Phases and counters of the run, only when asked for
+            std::unique_ptr<Profiler::Profiler> profiler;
+            if(current_execution_flags.profile)
+            {
+                profiler.reset(new Profiler::Profiler());
+            }
+
+            //Timeline of the builds, analyses and writes of every module, only when asked for
+            std::unique_ptr<Trace::Recorder> recorder;
+            if(!current_execution_flags.traceFile.empty())
+            {
+                recorder.reset(new Trace::Recorder());
+                recorder->start();
+            }
+
+            //Signal names are interned for the lifetime of the analyzer: a full table is reported here, on the thread that runs the pass
+            try
+            {
+                //This must be a singleton. It's not implemented like that in our project though. If future releases need two of this, be careful with files handling.
+                DesignAnalyzer::DesignAnalyzer dAnalyzer(design, current_execution_flags.threads, current_execution_flags.cacheDirectory,
+                                                         current_execution_flags.incremental ? residentState(design) : nullptr, profiler.get());
             
-            //dAnalyzer.PRINT_allModulesSupportGraphs();
+                //dAnalyzer.PRINT_allModulesSupportGraphs();
             
-            if(current_execution_flags.printModules)
-            {
-               dAnalyzer.PRINT_allModules();
-            }
-
-            //Final Results for File
-            DesignAnalyzer::Final_Results frf;
-            frf = dAnalyzer.DFS(    
-                                    true,      //Deep scan heritage
-                                    current_execution_flags.condenseResults,    //Condense results
-                                    current_execution_flags.print_STDOUT || current_execution_flags.print_PLAINTEXT,    //Prepare the plaintext for output/plaintext file
-                                    current_execution_flags.print_XML,  //Prepare the xml for xml file
-                                    current_execution_flags.print_JSON, //Prepare the json for json file
-                                    current_execution_flags.print_CSV   //Prepare the csv for csv file
-                                );
-            outputResults(frf);
+                if(current_execution_flags.printModules)
+                {
+                   dAnalyzer.PRINT_allModules();
+                }
+
+                //Writers of the requested outputs: modules are written as soon as they are analyzed
+                std::vector<std::unique_ptr<ResultWriter::ResultWriter>> writers = createWriters();
+                std::vector<ResultWriter::ResultWriter *> sinks;
+                for(auto &writer : writers)
+                {
+                    sinks.push_back(writer.get());
+                }
+
+                dAnalyzer.DFS(
+                                true,      //Deep scan heritage
+                                sinks,     //Writers of the requested outputs
+                                current_execution_flags.condenseResults,    //Condense results
+                                current_execution_flags.componentReachability,  //Answer starting nodes from the SCC-condensed summary
+                                current_execution_flags.laneSweep,  //Resolve all the slices together with the bit-parallel lane propagation
+                                current_execution_flags.conePruning,    //Drop the parts of the graphs outside the cones of the entering signals
+                                current_execution_flags.threads     //Workers analyzing modules in parallel (0 = one per hardware thread)
+                             );
+            }
+            catch(const std::overflow_error &e)
+            {
+                log_error("%s\n", e.what());
+            }
+
+            if(recorder)
+            {
+                recorder->stop();
+
+                if(recorder->dropped() > 0)
+                {
+                    log_warning("The trace lost its %llu oldest events, the buffers of the threads were full.\n", (unsigned long long)recorder->dropped());
+                }
+
+                if(!recorder->writeChromeTrace(current_execution_flags.traceFile))
+                {
+                    log_warning("Cannot write the trace to %s.\n", current_execution_flags.traceFile.c_str());
+                }
+            }
+
+            if(profiler)
+            {
+                profiler->stop();
+                profiler->logTables();
+
+                if(!profiler->writeJSON(FILE_PROFILE))
+                {
+                    log_warning("Cannot write the profile to %s.\n", FILE_PROFILE);
+                }
+            }
 		}
 
 
@@ -22,19 +22,19 @@
 USING_YOSYS_NAMESPACE
 
 Graph_Port::Port::Port() : portName(""), portId(-1), direction(INVALID), connectedToExtern(false) {}
-Graph_Port::Port::Port(std::string portName) : portName(portName), portId(-1), direction(INVALID), connectedToExtern(false) {}
-Graph_Port::Port::Port(std::string portName, int portId) : portName(portName), portId(portId), direction(INVALID), connectedToExtern(false) {}
-Graph_Port::Port::Port(std::string portName, PortDirection portDirection) : portName(portName), portId(-1), direction(portDirection), connectedToExtern(false) {}
-Graph_Port::Port::Port(std::string portName, PortDirection portDirection, int portId) : portName(portName), portId(portId), direction(portDirection), connectedToExtern(false) {}
+Graph_Port::Port::Port(std::string portName) : portName(std::move(portName)), portId(-1), direction(INVALID), connectedToExtern(false) {}
+Graph_Port::Port::Port(std::string portName, int portId) : portName(std::move(portName)), portId(portId), direction(INVALID), connectedToExtern(false) {}
+Graph_Port::Port::Port(std::string portName, PortDirection portDirection) : portName(std::move(portName)), portId(-1), direction(portDirection), connectedToExtern(false) {}
+Graph_Port::Port::Port(std::string portName, PortDirection portDirection, int portId) : portName(std::move(portName)), portId(portId), direction(portDirection), connectedToExtern(false) {}
 
 //Getters
-std::string Graph_Port::Port::getPortName() { return this->portName; }
-int Graph_Port::Port::getPortId() { return this->portId; }
-Graph_Port::PortDirection Graph_Port::Port::getPortDirection() { return this->direction; }
-pool<int> Graph_Port::Port::getEdges() { return this->edges; }
-std::vector<Signal::Signal> Graph_Port::Port::getInputSignals() { return this->inputSignals; }
-std::vector<Signal::Signal> Graph_Port::Port::getOutputSignals() { return this->outputSignals; }
-bool Graph_Port::Port::isConnectedToExtern() { return this->connectedToExtern; }
+const std::string &Graph_Port::Port::getPortName() const { return this->portName; }
+int Graph_Port::Port::getPortId() const { return this->portId; }
+Graph_Port::PortDirection Graph_Port::Port::getPortDirection() const { return this->direction; }
+const pool<int> &Graph_Port::Port::getEdges() const { return this->edges; }
+const std::vector<Signal::Signal> &Graph_Port::Port::getInputSignals() const { return this->inputSignals; }
+const std::vector<Signal::Signal> &Graph_Port::Port::getOutputSignals() const { return this->outputSignals; }
+bool Graph_Port::Port::isConnectedToExtern() const { return this->connectedToExtern; }
 
 std::vector<Signal::Signal> Graph_Port::Port::getSignals()
 {
@@ -65,7 +65,7 @@ bool Graph_Port::Port::isValidPortDirection(PortDirection dir)
 	return true;
 }
 
-bool Graph_Port::Port::isInputPort()
+bool Graph_Port::Port::isInputPort() const
 {
 	if( this->direction == INPUT )
 	{
@@ -74,14 +74,14 @@ bool Graph_Port::Port::isInputPort()
 	return false;
 }
 
-bool Graph_Port::Port::isOutputPort()
+bool Graph_Port::Port::isOutputPort() const
 {
 	if( this->direction == OUTPUT )
 		return true;
 	return false;
 }
 
-bool Graph_Port::Port::isInOutPort()
+bool Graph_Port::Port::isInOutPort() const
 {
 	if( this->direction == INOUT )
 	{
@@ -90,7 +90,7 @@ bool Graph_Port::Port::isInOutPort()
 	return false;
 }
 
-bool Graph_Port::Port::isInvalidPort()
+bool Graph_Port::Port::isInvalidPort() const
 {
 	if( this->direction == INVALID )
 	{
@@ -99,7 +99,7 @@ bool Graph_Port::Port::isInvalidPort()
 	return false;
 }
 
-void Graph_Port::Port::pushInputSignal(Signal::Signal sig)
+void Graph_Port::Port::pushInputSignal(const Signal::Signal &sig)
 {
 	if( !Signal::isIn(this->inputSignals, sig) )
 	{
@@ -107,7 +107,7 @@ void Graph_Port::Port::pushInputSignal(Signal::Signal sig)
 	}
 }
 
-void Graph_Port::Port::pushOutputSignal(Signal::Signal sig)
+void Graph_Port::Port::pushOutputSignal(const Signal::Signal &sig)
 {
 	if( !Signal::isIn(this->outputSignals, sig) )
 	{
@@ -115,7 +115,7 @@ void Graph_Port::Port::pushOutputSignal(Signal::Signal sig)
 	}
 }
 
-void Graph_Port::Port::pushInOutSignal(Signal::Signal sig)
+void Graph_Port::Port::pushInOutSignal(const Signal::Signal &sig)
 {
 	pushInputSignal(sig);
 	pushOutputSignal(sig);
@@ -67,14 +67,14 @@ namespace Graph_Port
 			Port(std::string portName, PortDirection portDirection);
 			Port(std::string portName, PortDirection portDirection, int portId);
 
-			//Getters
-			std::string getPortName();
-			int getPortId();
-			PortDirection getPortDirection();
-			pool<int> getEdges();
-			std::vector<Signal::Signal> getInputSignals();
-			std::vector<Signal::Signal> getOutputSignals();
-			bool isConnectedToExtern();
+			//Getters. Containers are returned by reference: they stay valid as long as the port does.
+			const std::string &getPortName() const;
+			int getPortId() const;
+			PortDirection getPortDirection() const;
+			const pool<int> &getEdges() const;
+			const std::vector<Signal::Signal> &getInputSignals() const;
+			const std::vector<Signal::Signal> &getOutputSignals() const;
+			bool isConnectedToExtern() const;
 
 			/*
 			 *	Getter for the whole bunch of connected signals.
@@ -97,37 +97,37 @@ namespace Graph_Port
 			/*
 			 *	Method to know if said port is an input port.
 			 */
-			bool isInputPort();
+			bool isInputPort() const;
 
 			/*
 			 *	Method to know if said port is an output port.
 			 */
-			bool isOutputPort();
+			bool isOutputPort() const;
 
 			/*
 			 *	Method to know if said port is an inout port.
 			 */
-			bool isInOutPort();
+			bool isInOutPort() const;
 
 			/*
 			 *	Method to know if said port is an invalid port.
 			 */
-			bool isInvalidPort();
+			bool isInvalidPort() const;
 
 			/*
 			 *	Safely push a signal in the signal vector
 			 */
-			void pushInputSignal(Signal::Signal sig);
+			void pushInputSignal(const Signal::Signal &sig);
 
 			/*
 			 *	Safely push a signal in the signal vector
 			 */
-			void pushOutputSignal(Signal::Signal sig);
+			void pushOutputSignal(const Signal::Signal &sig);
 
 			/*
 			 *	Safely push a signal in the signal vector
 			 */
-			void pushInOutSignal(Signal::Signal sig);
+			void pushInOutSignal(const Signal::Signal &sig);
 
 			/*
 			 *	Push an edge in the pool.
@@ -0,0 +1,247 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Standard libraries
+#include <algorithm>
+#include <fstream>
+#include <sys/resource.h>
+
+//Application libraries
+#include "profiler.h"
+#include "stdstring_support.h"
+
+USING_YOSYS_NAMESPACE
+
+namespace
+{
+    thread_local Profiler::ModuleProfile *currentProfile = nullptr;
+
+    double milliseconds(int64_t nanoseconds)
+    {
+        return nanoseconds * 1e-6;
+    }
+}
+
+const char *Profiler::phaseName(Phase phase)
+{
+    static const char *names[PHASE_COUNT] = { "mod2graph", "buildGraph", "check", "DFS_FTSA", "deepScan", "output" };
+
+    return names[phase];
+}
+
+const char *Profiler::counterName(Counter counter)
+{
+    static const char *names[COUNTER_COUNT] = { "traversals", "edgesScanned", "nodesVisited", "summaryHits", "summaryMisses", "peakNodes", "peakEdges" };
+
+    return names[counter];
+}
+
+Profiler::ModuleProfile *Profiler::current() { return currentProfile; }
+
+Profiler::ModuleScope::ModuleScope(ModuleProfile *profile)
+{
+    this->previous = currentProfile;
+    currentProfile = profile;
+}
+
+Profiler::ModuleScope::~ModuleScope()
+{
+    currentProfile = this->previous;
+}
+
+Profiler::PhaseTimer::PhaseTimer(Phase phase)
+{
+    this->profile = currentProfile;
+    this->phase = phase;
+
+    if(this->profile != nullptr)
+    {
+        this->start = std::chrono::steady_clock::now();
+    }
+}
+
+Profiler::PhaseTimer::~PhaseTimer()
+{
+    if(this->profile != nullptr)
+    {
+        this->profile->phaseNanoseconds[this->phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count();
+    }
+}
+
+Profiler::Profiler::Profiler()
+{
+    this->start = std::chrono::steady_clock::now();
+    this->cpu.begin();
+}
+
+Profiler::ModuleProfile *Profiler::Profiler::module(const std::string &moduleName)
+{
+    auto found = this->byName.find(moduleName);
+
+    if(found != this->byName.end())
+    {
+        return found->second;
+    }
+
+    this->modules.emplace_back(new ModuleProfile());
+    this->modules.back()->moduleName = moduleName;
+    this->byName[moduleName] = this->modules.back().get();
+
+    return this->modules.back().get();
+}
+
+void Profiler::Profiler::stop()
+{
+    this->cpu.end();
+    this->wallNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - this->start).count();
+
+    //High-water mark of the whole process, so it covers what the earlier passes of the script used too (kilobytes on Linux)
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        this->peakResidentKb = usage.ru_maxrss;
+    }
+}
+
+Profiler::ModuleProfile Profiler::Profiler::total() const
+{
+    ModuleProfile sum;
+    sum.moduleName = "total";
+
+    for(auto &profile : this->modules)
+    {
+        for(int p = 0; p < PHASE_COUNT; p++)
+        {
+            sum.phaseNanoseconds[p] += profile->phaseNanoseconds[p];
+        }
+
+        for(int c = 0; c < COUNTER_COUNT; c++)
+        {
+            if(c == COUNTER_PEAK_NODES || c == COUNTER_PEAK_EDGES)
+            {
+                sum.counters[c] = std::max(sum.counters[c], profile->counters[c]);
+            }
+            else
+            {
+                sum.counters[c] += profile->counters[c];
+            }
+        }
+    }
+
+    return sum;
+}
+
+void Profiler::Profiler::logTables() const
+{
+    ModuleProfile sum = this->total();
+    size_t nameWidth = sum.moduleName.size();
+
+    for(auto &profile : this->modules)
+    {
+        nameWidth = std::max(nameWidth, profile->moduleName.size());
+    }
+
+    std::vector<const ModuleProfile *> rows;
+    for(auto &profile : this->modules)
+    {
+        rows.push_back(profile.get());
+    }
+    rows.push_back(&sum);
+
+    log("\nProfile: %.3f s wall, %.3f s CPU over all the threads, %lld KB peak resident memory.\n", milliseconds(this->wallNanoseconds) / 1000,
+        this->cpu.sec(), this->peakResidentKb);
+
+    log("\nWall time per phase (ms):\n  %-*s", (int)nameWidth, "module");
+    for(int p = 0; p < PHASE_COUNT; p++)
+    {
+        log(" %12s", phaseName((Phase)p));
+    }
+    log("\n");
+
+    for(auto row : rows)
+    {
+        log("  %-*s", (int)nameWidth, row->moduleName.c_str());
+        for(int p = 0; p < PHASE_COUNT; p++)
+        {
+            log(" %12.3f", milliseconds(row->phaseNanoseconds[p]));
+        }
+        log("\n");
+    }
+
+    log("\nCounters:\n  %-*s", (int)nameWidth, "module");
+    for(int c = 0; c < COUNTER_COUNT; c++)
+    {
+        log(" %14s", counterName((Counter)c));
+    }
+    log("\n");
+
+    for(auto row : rows)
+    {
+        log("  %-*s", (int)nameWidth, row->moduleName.c_str());
+        for(int c = 0; c < COUNTER_COUNT; c++)
+        {
+            log(" %14lld", row->counters[c]);
+        }
+        log("\n");
+    }
+
+    log("\n");
+}
+
+bool Profiler::Profiler::writeJSON(const std::string &filepath) const
+{
+    std::ofstream json(filepath, std::ios::out | std::ios::trunc);
+
+    if(!json.is_open())
+    {
+        return false;
+    }
+
+    auto writeProfile = [&](const ModuleProfile &profile)
+    {
+        json << "{\"name\": \"" << StringSupport::jsonEscape(profile.moduleName) << "\", \"phasesNs\": {";
+        for(int p = 0; p < PHASE_COUNT; p++)
+        {
+            json << (p > 0 ? ", " : "") << "\"" << phaseName((Phase)p) << "\": " << profile.phaseNanoseconds[p];
+        }
+
+        json << "}, \"counters\": {";
+        for(int c = 0; c < COUNTER_COUNT; c++)
+        {
+            json << (c > 0 ? ", " : "") << "\"" << counterName((Counter)c) << "\": " << profile.counters[c];
+        }
+        json << "}}";
+    };
+
+    json << "{\n \"wallNs\": " << this->wallNanoseconds << ",\n \"cpuNs\": " << this->cpu.total_ns << ",\n \"peakRssKb\": " << this->peakResidentKb
+         << ",\n \"modules\": [\n";
+
+    for(size_t m = 0; m < this->modules.size(); m++)
+    {
+        json << "  ";
+        writeProfile(*this->modules[m]);
+        json << (m + 1 < this->modules.size() ? ",\n" : "\n");
+    }
+
+    json << " ],\n \"total\": ";
+    writeProfile(this->total());
+    json << "\n}\n";
+
+    return (bool)json;
+}
@@ -0,0 +1,170 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+//Standard libraries
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+//Yosys library
+#include "kernel/log.h"
+
+namespace Profiler
+{
+    /*
+     *  Phases timed for each module. mod2graph runs inside buildGraph, so its time is also part of the buildGraph one. deepScan is the
+     *  time spent handing the summary of the module to the nodes that instantiate it.
+     */
+    enum Phase
+    {
+        PHASE_MOD2GRAPH, PHASE_BUILD_GRAPH, PHASE_CHECK, PHASE_DFS_FTSA, PHASE_DEEP_SCAN, PHASE_OUTPUT, PHASE_COUNT
+    };
+
+    /*
+     *  Hot path counters. The PEAK_ ones keep the greatest value seen instead of a sum.
+     *      TRAVERSALS          walks of the frozen graph: single reachability questions, component sweeps and batches of lanes
+     *      EDGES_SCANNED       successors looked at by those walks, NODES_VISITED nodes they expanded
+     *      SUMMARY_HITS        port roles read from the summary of an inner module, SUMMARY_MISSES ports (or modules) without one
+     */
+    enum Counter
+    {
+        COUNTER_TRAVERSALS, COUNTER_EDGES_SCANNED, COUNTER_NODES_VISITED, COUNTER_SUMMARY_HITS, COUNTER_SUMMARY_MISSES,
+        COUNTER_PEAK_NODES, COUNTER_PEAK_EDGES, COUNTER_COUNT
+    };
+
+    const char *phaseName(Phase phase);
+    const char *counterName(Counter counter);
+
+    struct ModuleProfile
+    {
+        std::string moduleName;
+        //Wall time of each phase
+        int64_t phaseNanoseconds[PHASE_COUNT] = {};
+        long long counters[COUNTER_COUNT] = {};
+    };
+
+    /*
+     *  Profile the calling thread is working for, nullptr when nothing is being profiled. Timers and counters are dropped without one, so
+     *  the instrumented code costs a thread-local read when -profile is off.
+     */
+    ModuleProfile *current();
+
+    /*
+     *  Makes profile the current one of the calling thread until the end of the scope.
+     */
+    class ModuleScope
+    {
+        private:
+            ModuleProfile *previous;
+
+        public:
+            ModuleScope(ModuleProfile *profile);
+            ~ModuleScope();
+
+            ModuleScope(const ModuleScope &) = delete;
+            ModuleScope &operator=(const ModuleScope &) = delete;
+    };
+
+    /*
+     *  Adds the wall time until the end of the scope to a phase of the current profile.
+     */
+    class PhaseTimer
+    {
+        private:
+            ModuleProfile *profile;
+            Phase phase;
+            std::chrono::steady_clock::time_point start;
+
+        public:
+            PhaseTimer(Phase phase);
+            ~PhaseTimer();
+
+            PhaseTimer(const PhaseTimer &) = delete;
+            PhaseTimer &operator=(const PhaseTimer &) = delete;
+    };
+
+    inline void count(Counter counter, long long amount)
+    {
+        ModuleProfile *profile = current();
+
+        if(profile != nullptr)
+        {
+            profile->counters[counter] += amount;
+        }
+    }
+
+    inline void peak(Counter counter, long long value)
+    {
+        ModuleProfile *profile = current();
+
+        if(profile != nullptr && profile->counters[counter] < value)
+        {
+            profile->counters[counter] = value;
+        }
+    }
+
+    /*
+     *  Profile of a whole run: one ModuleProfile per module, plus the wall and the process CPU time of the run (the latter from Yosys'
+     *  PerformanceTimer, so it adds up the time of all the workers) and the peak resident memory of the process at its end.
+     */
+    class Profiler
+    {
+        private:
+            std::vector< std::unique_ptr<ModuleProfile> > modules;
+            std::map<std::string, ModuleProfile *> byName;
+
+            Yosys::PerformanceTimer cpu;
+            std::chrono::steady_clock::time_point start;
+            int64_t wallNanoseconds = 0;
+            long long peakResidentKb = 0;
+
+            //Sums over the modules, maximum for the PEAK_ counters
+            ModuleProfile total() const;
+
+        public:
+            //Starts the clocks of the run
+            Profiler();
+
+            /*
+             *  Profile of a module, created on first use. Not thread safe: get the profiles of all the modules before handing them to workers.
+             */
+            ModuleProfile *module(const std::string &moduleName);
+
+            //Stops the clocks of the run
+            void stop();
+
+            /*
+             *  Tables of the phases and of the counters, through the Yosys log.
+             */
+            void logTables() const;
+
+            /*
+             *  Same content as JSON. Returns false if the file cannot be written.
+             */
+            bool writeJSON(const std::string &filepath) const;
+    };
+}
+
+#endif
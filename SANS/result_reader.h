@@ -0,0 +1,441 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef RESULT_READER_H
+#define RESULT_READER_H
+
+/*
+ *  Reader of the binary report written by sans -bin. It only needs the standard library (plus mmap on POSIX systems), so it can be
+ *  copied into the tools that consume the results.
+ *
+ *  Layout of a file, little-endian, every section aligned to 8 bytes from the start of the file:
+ *
+ *      header          HEADER_SIZE bytes: MAGIC, VERSION, flags, counts and the offset of every section (see the OFFSET_* constants)
+ *      stringOffsets   u32[strings + 1]    string s is stringData[stringOffsets[s], stringOffsets[s + 1] - 1), NUL terminated
+ *      stringData      char[]              sorted by byte value, without duplicates
+ *      moduleName      u32[modules]        string of the module name
+ *      moduleSignals   u32[modules + 1]    signals of module m are the rows [moduleSignals[m], moduleSignals[m + 1])
+ *      signalName      u32[signals]        string of the signal name
+ *      signalMSB       i32[signals]
+ *      signalLSB       i32[signals]
+ *      signalSummary   u8[signals]         SUMMARY_DATA / SUMMARY_SELECT: the signal (or any of its bits) is data / select
+ *      signalWords     u32[signals + 1]    plane words of signal r are [signalWords[r], signalWords[r + 1]), empty if not condensed
+ *      dataPlane       u64[words]          bit i of the words of a signal: bit i (LSB first) of the signal is data
+ *      selectPlane     u64[words]          same for select
+ *
+ *  A file is written only after the whole analysis, an interrupted run leaves no valid header.
+ */
+
+//Standard libraries
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace ResultReader
+{
+    static const char MAGIC[8] = { 'S', 'A', 'N', 'S', 'B', 'I', 'N', '\0' };
+    static const uint32_t VERSION = 1;
+
+    //Bits of the flags field
+    static const uint32_t FLAG_CONDENSED = 1;
+
+    //Bits of signalSummary
+    static const uint8_t SUMMARY_DATA = 1;
+    static const uint8_t SUMMARY_SELECT = 2;
+
+    enum Section
+    {
+        STRING_OFFSETS, STRING_DATA, MODULE_NAME, MODULE_SIGNALS, SIGNAL_NAME, SIGNAL_MSB, SIGNAL_LSB, SIGNAL_SUMMARY, SIGNAL_WORDS,
+        DATA_PLANE, SELECT_PLANE, SECTION_COUNT
+    };
+
+    //Header fields, byte offsets
+    static const size_t OFFSET_MAGIC = 0;
+    static const size_t OFFSET_VERSION = 8;
+    static const size_t OFFSET_FLAGS = 12;
+    static const size_t OFFSET_MODULES = 16;
+    static const size_t OFFSET_SIGNALS = 20;
+    static const size_t OFFSET_STRINGS = 24;
+    static const size_t OFFSET_WORDS = 32;
+    static const size_t OFFSET_SECTIONS = 40;
+    static const size_t HEADER_SIZE = OFFSET_SECTIONS + 8 * SECTION_COUNT;
+
+    //Returned by the lookups when nothing matches
+    static const uint32_t NOT_FOUND = 0xFFFFFFFF;
+
+    /*
+     *  A string of the table, pointing into the file.
+     */
+    struct StringRef
+    {
+        const char *data;
+        uint32_t size;
+
+        std::string toString() const { return std::string(this->data, this->size); }
+
+        bool operator==(const std::string &other) const { return other.size() == this->size && std::memcmp(other.data(), this->data, this->size) == 0; }
+    };
+
+    /*
+     *  View over a report already in memory: nothing is copied, every accessor reads the columns in place. The buffer must outlive the
+     *  reader and start at an 8 byte boundary (mapped files and operator new do).
+     */
+    class ResultReader
+    {
+        private:
+            const unsigned char *base = nullptr;
+            size_t length = 0;
+            bool valid = false;
+
+            uint32_t flags = 0;
+            uint32_t modules = 0;
+            uint32_t signals = 0;
+            uint32_t strings = 0;
+            uint64_t words = 0;
+
+            const uint32_t *stringOffsets = nullptr;
+            const char *stringData = nullptr;
+            const uint32_t *moduleName = nullptr;
+            const uint32_t *moduleSignals = nullptr;
+            const uint32_t *signalName = nullptr;
+            const int32_t *signalMSB = nullptr;
+            const int32_t *signalLSB = nullptr;
+            const uint8_t *signalSummary = nullptr;
+            const uint32_t *signalWords = nullptr;
+            const uint64_t *dataPlane = nullptr;
+            const uint64_t *selectPlane = nullptr;
+
+            template<typename T>
+            T field(size_t offset) const
+            {
+                T value;
+                std::memcpy(&value, this->base + offset, sizeof(T));
+                return value;
+            }
+
+            /*
+             *  Start of a section if it holds count elements of size bytes inside the file, nullptr otherwise.
+             */
+            const void *section(int s, uint64_t count, size_t size) const
+            {
+                uint64_t offset = this->field<uint64_t>(OFFSET_SECTIONS + 8 * s);
+
+                if(offset % 8 != 0 || offset > this->length || count > (this->length - offset) / size)
+                {
+                    return nullptr;
+                }
+
+                return this->base + offset;
+            }
+
+            /*
+             *  True if the count + 1 entries of an index column go from 0 to end without ever decreasing.
+             */
+            static bool monotonic(const uint32_t *column, uint64_t count, uint64_t end)
+            {
+                for(uint64_t i = 0; i < count; i++)
+                {
+                    if(column[i] > column[i + 1])
+                    {
+                        return false;
+                    }
+                }
+
+                return column[0] == 0 && column[count] == end;
+            }
+
+            /*
+             *  True if every string id of a column is in the table.
+             */
+            bool inTable(const uint32_t *column, uint64_t count) const
+            {
+                for(uint64_t i = 0; i < count; i++)
+                {
+                    if(column[i] >= this->strings)
+                    {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            /*
+             *  Byte order of string s against text, like std::string::compare.
+             */
+            int compare(uint32_t s, const std::string &text) const
+            {
+                StringRef ref = this->getString(s);
+                int order = std::memcmp(ref.data, text.data(), std::min<size_t>(ref.size, text.size()));
+
+                if(order != 0)
+                {
+                    return order;
+                }
+
+                return ref.size < text.size() ? -1 : (ref.size > text.size() ? 1 : 0);
+            }
+
+            static bool littleEndianHost()
+            {
+                uint16_t probe = 1;
+                unsigned char first;
+                std::memcpy(&first, &probe, 1);
+                return first == 1;
+            }
+
+        public:
+            ResultReader() {}
+
+            ResultReader(const void *data, size_t size)
+            {
+                this->base = static_cast<const unsigned char *>(data);
+                this->length = size;
+
+                if(!littleEndianHost() || size < HEADER_SIZE || std::memcmp(this->base + OFFSET_MAGIC, MAGIC, sizeof(MAGIC)) != 0
+                   || this->field<uint32_t>(OFFSET_VERSION) != VERSION)
+                {
+                    return;
+                }
+
+                this->flags = this->field<uint32_t>(OFFSET_FLAGS);
+                this->modules = this->field<uint32_t>(OFFSET_MODULES);
+                this->signals = this->field<uint32_t>(OFFSET_SIGNALS);
+                this->strings = this->field<uint32_t>(OFFSET_STRINGS);
+                this->words = this->field<uint64_t>(OFFSET_WORDS);
+
+                this->stringOffsets = static_cast<const uint32_t *>(this->section(STRING_OFFSETS, (uint64_t)this->strings + 1, 4));
+                this->moduleName = static_cast<const uint32_t *>(this->section(MODULE_NAME, this->modules, 4));
+                this->moduleSignals = static_cast<const uint32_t *>(this->section(MODULE_SIGNALS, (uint64_t)this->modules + 1, 4));
+                this->signalName = static_cast<const uint32_t *>(this->section(SIGNAL_NAME, this->signals, 4));
+                this->signalMSB = static_cast<const int32_t *>(this->section(SIGNAL_MSB, this->signals, 4));
+                this->signalLSB = static_cast<const int32_t *>(this->section(SIGNAL_LSB, this->signals, 4));
+                this->signalSummary = static_cast<const uint8_t *>(this->section(SIGNAL_SUMMARY, this->signals, 1));
+                this->signalWords = static_cast<const uint32_t *>(this->section(SIGNAL_WORDS, (uint64_t)this->signals + 1, 4));
+                this->dataPlane = static_cast<const uint64_t *>(this->section(DATA_PLANE, this->words, 8));
+                this->selectPlane = static_cast<const uint64_t *>(this->section(SELECT_PLANE, this->words, 8));
+
+                if(!this->stringOffsets || !this->moduleName || !this->moduleSignals || !this->signalName || !this->signalMSB
+                   || !this->signalLSB || !this->signalSummary || !this->signalWords || !this->dataPlane || !this->selectPlane)
+                {
+                    return;
+                }
+
+                this->stringData = static_cast<const char *>(this->section(STRING_DATA, this->stringOffsets[this->strings], 1));
+
+                if(!this->stringData || this->stringOffsets[0] != 0)
+                {
+                    return;
+                }
+
+                //Every string keeps at least its terminator, so the offsets strictly increase up to the size of stringData
+                for(uint32_t s = 0; s < this->strings; s++)
+                {
+                    if(this->stringOffsets[s] >= this->stringOffsets[s + 1] || this->stringData[this->stringOffsets[s + 1] - 1] != '\0')
+                    {
+                        return;
+                    }
+                }
+
+                //Nothing below is checked again by the accessors
+                if(!this->inTable(this->moduleName, this->modules) || !this->inTable(this->signalName, this->signals)
+                   || !monotonic(this->moduleSignals, this->modules, this->signals) || !monotonic(this->signalWords, this->signals, this->words))
+                {
+                    return;
+                }
+
+                this->valid = true;
+            }
+
+            /*
+             *  False for a buffer that is not a report of this version (or is truncated, or its indexes point outside
+             *  their columns), or on a big-endian host.
+             */
+            bool isValid() const { return this->valid; }
+
+            bool isCondensed() const { return (this->flags & FLAG_CONDENSED) != 0; }
+
+            uint32_t moduleCount() const { return this->modules; }
+            uint32_t signalCount() const { return this->signals; }
+
+            StringRef getString(uint32_t s) const
+            {
+                StringRef ref;
+                ref.data = this->stringData + this->stringOffsets[s];
+                ref.size = this->stringOffsets[s + 1] - this->stringOffsets[s] - 1;
+                return ref;
+            }
+
+            /*
+             *  Index of a string in the table, NOT_FOUND if the name never occurs. Binary search: the table is sorted.
+             */
+            uint32_t findString(const std::string &text) const
+            {
+                uint32_t low = 0;
+                uint32_t high = this->strings;
+
+                while(low < high)
+                {
+                    uint32_t middle = low + (high - low) / 2;
+                    int order = this->compare(middle, text);
+
+                    if(order == 0)
+                    {
+                        return middle;
+                    }
+
+                    if(order < 0)
+                    {
+                        low = middle + 1;
+                    }
+                    else
+                    {
+                        high = middle;
+                    }
+                }
+
+                return NOT_FOUND;
+            }
+
+            //Modules, in the order of the report
+            StringRef getModuleName(uint32_t m) const { return this->getString(this->moduleName[m]); }
+            uint32_t firstSignal(uint32_t m) const { return this->moduleSignals[m]; }
+            uint32_t endSignal(uint32_t m) const { return this->moduleSignals[m + 1]; }
+
+            uint32_t findModule(const std::string &name) const
+            {
+                uint32_t s = this->findString(name);
+
+                for(uint32_t m = 0; s != NOT_FOUND && m < this->modules; m++)
+                {
+                    if(this->moduleName[m] == s)
+                    {
+                        return m;
+                    }
+                }
+
+                return NOT_FOUND;
+            }
+
+            //Signal rows, grouped by module
+            StringRef getSignalName(uint32_t r) const { return this->getString(this->signalName[r]); }
+            int32_t getMSB(uint32_t r) const { return this->signalMSB[r]; }
+            int32_t getLSB(uint32_t r) const { return this->signalLSB[r]; }
+            bool isData(uint32_t r) const { return (this->signalSummary[r] & SUMMARY_DATA) != 0; }
+            bool isSelect(uint32_t r) const { return (this->signalSummary[r] & SUMMARY_SELECT) != 0; }
+
+            /*
+             *  Row of a signal of module m, NOT_FOUND if there is none. A name can have more rows in a module (one per slice when not
+             *  condensing): this is the first one, the others follow it.
+             */
+            uint32_t findSignal(uint32_t m, const std::string &name) const
+            {
+                uint32_t s = this->findString(name);
+
+                for(uint32_t r = this->moduleSignals[m]; s != NOT_FOUND && r < this->moduleSignals[m + 1]; r++)
+                {
+                    if(this->signalName[r] == s)
+                    {
+                        return r;
+                    }
+                }
+
+                return NOT_FOUND;
+            }
+
+            /*
+             *  Plane words of a row, LSB first (condensed reports only, 0 words otherwise).
+             */
+            uint32_t wordCount(uint32_t r) const { return this->signalWords[r + 1] - this->signalWords[r]; }
+            const uint64_t *getDataWords(uint32_t r) const { return this->dataPlane + this->signalWords[r]; }
+            const uint64_t *getSelectWords(uint32_t r) const { return this->selectPlane + this->signalWords[r]; }
+
+            /*
+             *  Bit of a condensed row, counted from the LSB of the signal.
+             */
+            bool isDataBit(uint32_t r, int bit) const { return (this->getDataWords(r)[bit / 64] >> (bit % 64)) & 1; }
+            bool isSelectBit(uint32_t r, int bit) const { return (this->getSelectWords(r)[bit / 64] >> (bit % 64)) & 1; }
+    };
+
+#if defined(__unix__) || defined(__APPLE__)
+    /*
+     *  Read-only mapping of a report file, with the reader over it.
+     */
+    class MappedResults
+    {
+        private:
+            void *mapping = nullptr;
+            size_t length = 0;
+            ResultReader view;
+
+        public:
+            explicit MappedResults(const std::string &filepath)
+            {
+                int fd = ::open(filepath.c_str(), O_RDONLY);
+                struct stat info;
+
+                if(fd < 0)
+                {
+                    return;
+                }
+
+                if(::fstat(fd, &info) == 0 && info.st_size > 0)
+                {
+                    void *address = ::mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+                    if(address != MAP_FAILED)
+                    {
+                        this->mapping = address;
+                        this->length = (size_t)info.st_size;
+                        this->view = ResultReader(address, this->length);
+                    }
+                }
+
+                ::close(fd);
+            }
+
+            ~MappedResults()
+            {
+                if(this->mapping != nullptr)
+                {
+                    ::munmap(this->mapping, this->length);
+                }
+            }
+
+            MappedResults(const MappedResults &) = delete;
+            MappedResults &operator=(const MappedResults &) = delete;
+
+            /*
+             *  Check reader().isValid() before using it.
+             */
+            const ResultReader &reader() const { return this->view; }
+    };
+#endif
+}
+
+#endif
@@ -0,0 +1,466 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Standard libraries
+#include <algorithm>
+#include <cstring>
+
+//Application libraries
+#include "result_writer.h"
+#include "result_reader.h"
+#include "stdstring_support.h"
+
+namespace
+{
+    bool littleEndianHost()
+    {
+        uint16_t probe = 1;
+        unsigned char first;
+        std::memcpy(&first, &probe, 1);
+        return first == 1;
+    }
+
+    void writeLittleEndian(std::ostream &out, uint64_t value, size_t bytes)
+    {
+        char buffer[8];
+
+        for(size_t b = 0; b < bytes; b++)
+        {
+            buffer[b] = (char)(value >> (8 * b));
+        }
+
+        out.write(buffer, bytes);
+    }
+
+    //Zeros up to the next multiple of 8 of position
+    uint64_t pad(std::ostream &out, uint64_t position)
+    {
+        static const char zeros[8] = { 0 };
+        uint64_t padding = (8 - position % 8) % 8;
+
+        out.write(zeros, padding);
+
+        return position + padding;
+    }
+
+    /*
+     *  Writes a column at position (already aligned) and returns the position after it, aligned again.
+     */
+    template<typename T>
+    uint64_t writeColumn(std::ostream &out, uint64_t position, const std::vector<T> &column)
+    {
+        if(littleEndianHost())
+        {
+            out.write(reinterpret_cast<const char *>(column.data()), column.size() * sizeof(T));
+        }
+        else
+        {
+            for(T value : column)
+            {
+                writeLittleEndian(out, (uint64_t)value, sizeof(T));
+            }
+        }
+
+        return pad(out, position + column.size() * sizeof(T));
+    }
+}
+
+ResultWriter::ResultWriter::ResultWriter(std::ostream &out, bool condense)
+{
+    this->out = &out;
+    this->condense = condense;
+}
+
+ResultWriter::ResultWriter::ResultWriter(const std::string &filepath, bool condense, bool binary)
+{
+    this->file.reset(new std::ofstream());
+    this->fileBuffer.reset(new char[FILE_BUFFER_SIZE]);
+
+    //The buffer must be in place before the file is opened
+    this->file->rdbuf()->pubsetbuf(this->fileBuffer.get(), FILE_BUFFER_SIZE);
+    this->file->open(filepath, binary ? std::ios::out | std::ios::trunc | std::ios::binary : std::ios::out | std::ios::trunc);
+
+    this->out = this->file.get();
+    this->condense = condense;
+}
+
+ResultWriter::ResultWriter::~ResultWriter()
+{
+    if(this->file)
+    {
+        this->file->close();
+    }
+}
+
+bool ResultWriter::ResultWriter::isOpen() const
+{
+    return this->file == nullptr || this->file->is_open();
+}
+
+void ResultWriter::ResultWriter::begin() { }
+
+void ResultWriter::ResultWriter::end()
+{
+    *this->out << std::endl;
+}
+
+void ResultWriter::PlaintextWriter::writeModule(const std::string &/*moduleName*/, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                                                const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results)
+{
+    std::ostream &plaintext = *this->out;
+
+    plaintext << "\n========================= { Module: " << title << " } =========================\n\n";
+
+    //Not condensing
+    if(!this->condense)
+    {
+        for( const auto &pair : results )
+        {
+            plaintext << "\t" << pair.first.toString() << "\t<" << pair.second.first << " " << pair.second.second << ">\n";
+        }
+
+        plaintext << "\n";
+    }
+    //Condensing
+    else
+    {
+        for( const auto &pair : sliceStructure )
+        {
+            plaintext << "\t" << pair.first.toString() << " [" << pair.second.toString() << "]\n";
+        }
+    }
+
+    plaintext << "\n";
+}
+
+void ResultWriter::XMLWriter::begin()
+{
+    if(this->condense)
+    {
+        *this->out << "<condensed>\n";
+    }
+    else
+    {
+        *this->out << "<wholesignals>\n";
+    }
+}
+
+void ResultWriter::XMLWriter::writeModule(const std::string &/*moduleName*/, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                                          const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results)
+{
+    std::ostream &xml = *this->out;
+
+    xml << "<module>\n" << "\t<name>\n\t\t" << title << "\n\t</name>\n";
+
+    //Not condensing
+    if(!this->condense)
+    {
+        for( const auto &pair : results )
+        {
+            xml << "\t<signal>\n";
+            xml << "\t\t<signalName>" << pair.first.toString() << "</signalName>\n";
+            xml << "\t\t<data>" << pair.second.first << "</data>\n";
+            xml << "\t\t<select>" << pair.second.second << "</select>\n";
+            xml << "\t</signal>\n";
+        }
+    }
+    //Condensing
+    else
+    {
+        for( const auto &pair : sliceStructure )
+        {
+            xml << "\t<signal>\n";
+            xml << "\t\t<signalName>" << pair.first.toString() << "</signalName>\n";
+            xml << "\t\t<slice>" << pair.second.toString() << "</slice>\n\t</signal>\n";
+        }
+    }
+
+    xml << "</module>\n";
+}
+
+void ResultWriter::XMLWriter::end()
+{
+    if(this->condense)
+    {
+        *this->out << "</condensed>";
+    }
+    else
+    {
+        *this->out << "</wholesignals>";
+    }
+
+    ResultWriter::end();
+}
+
+void ResultWriter::JSONWriter::writeModule(const std::string &/*moduleName*/, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                                           const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results)
+{
+    std::ostream &json = *this->out;
+
+    json << "{\"module\": {\n \"name\": \"" << StringSupport::jsonEscape(title) << "\",\n \"signals\": [\n";
+
+    //Not condensing
+    if(!this->condense)
+    {
+        for( size_t k = 0; k < results.size(); k++ )
+        {
+            json << "     {\"signalName\": \"" << StringSupport::jsonEscape(results[k].first.toString()) << "\", \"data\": \"" << results[k].second.first
+                 << "\", \"select\": \"" << results[k].second.second << "\"}" << (k + 1 < results.size() ? ",\n" : "\n");
+        }
+    }
+    //Condensing
+    else
+    {
+        for( size_t k = 0; k < sliceStructure.size(); k++ )
+        {
+            json << "     {\"signalName\": \"" << StringSupport::jsonEscape(sliceStructure[k].first.toString()) << "\", \"slice\": \"" << sliceStructure[k].second.toString()
+                 << "\"}" << (k + 1 < sliceStructure.size() ? ",\n" : "\n");
+        }
+    }
+
+    json << "   ]\n  }\n}\n\n";
+}
+
+void ResultWriter::NDJSONWriter::writeModule(const std::string &moduleName, const std::string &/*title*/, const SlicePlanes::SliceStructure &sliceStructure,
+                                             const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results)
+{
+    std::ostream &ndjson = *this->out;
+    std::string module = "{\"module\":\"" + StringSupport::jsonEscape(moduleName) + "\",\"signal\":\"";
+
+    //Not condensing
+    if(!this->condense)
+    {
+        for( const auto &pair : results )
+        {
+            ndjson << module << StringSupport::jsonEscape(pair.first.getSignalName()) << "\",\"msb\":" << pair.first.getMSB() << ",\"lsb\":" << pair.first.getLSB()
+                   << ",\"data\":" << (pair.second.first ? "true" : "false") << ",\"select\":" << (pair.second.second ? "true" : "false") << "}\n";
+        }
+    }
+    //Condensing
+    else
+    {
+        for( const auto &pair : sliceStructure )
+        {
+            ndjson << module << StringSupport::jsonEscape(pair.first.getSignalName()) << "\",\"msb\":" << pair.first.getMSB() << ",\"lsb\":" << pair.first.getLSB()
+                   << ",\"slice\":\"" << pair.second.toString() << "\"}\n";
+        }
+    }
+
+    //Records of a module are complete: whoever tails the file can ingest them now
+    ndjson.flush();
+}
+
+void ResultWriter::NDJSONWriter::end()
+{
+    this->out->flush();
+}
+
+void ResultWriter::CSVWriter::writeModule(const std::string &/*moduleName*/, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                                          const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results)
+{
+    std::ostream &csv = *this->out;
+
+    //Not condensing
+    if(!this->condense)
+    {
+        csv << "\"ModuleName\",\t\"signalName\",\t\"data\",\t\"select\"\n";
+
+        for( const auto &pair : results )
+        {
+            csv << "\"" <<  title << "\",\t\"" << pair.first.toString() << "\",\t" << pair.second.first << ",\t" << pair.second.second << "\n";
+        }
+    }
+    //Condensing
+    else
+    {
+        csv << "\"ModuleName\",\t\"signalName\",\t\"slice\"\n";
+
+        for( const auto &pair : sliceStructure )
+        {
+            csv << "\"" <<  title << "\",\t\"" << pair.first.toString() << "\",\t\"" << pair.second.toString() << "\"\n";
+        }
+    }
+
+    csv << "\n";
+}
+
+ResultWriter::BinaryWriter::BinaryWriter(const std::string &filepath, bool condense) : ResultWriter(filepath, condense, true)
+{
+    this->moduleSignals.push_back(0);
+    this->signalWords.push_back(0);
+}
+
+uint32_t ResultWriter::BinaryWriter::intern(const std::string &text)
+{
+    auto found = this->stringIds.find(text);
+
+    if(found != this->stringIds.end())
+    {
+        return found->second;
+    }
+
+    uint32_t id = (uint32_t)this->strings.size();
+    this->strings.push_back(text);
+    this->stringIds[text] = id;
+
+    return id;
+}
+
+uint32_t ResultWriter::BinaryWriter::intern(const Signal::Signal &signal)
+{
+    auto found = this->signalIds.find(signal.getSignalId());
+
+    if(found != this->signalIds.end())
+    {
+        return found->second;
+    }
+
+    uint32_t id = this->intern(signal.getSignalName());
+    this->signalIds[signal.getSignalId()] = id;
+
+    return id;
+}
+
+void ResultWriter::BinaryWriter::writeModule(const std::string &moduleName, const std::string &/*title*/, const SlicePlanes::SliceStructure &sliceStructure,
+                                             const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results)
+{
+    this->moduleNames.push_back(this->intern(moduleName));
+
+    //Not condensing
+    if(!this->condense)
+    {
+        for( const auto &pair : results )
+        {
+            this->signalNames.push_back(this->intern(pair.first));
+            this->signalMSB.push_back(pair.first.getMSB());
+            this->signalLSB.push_back(pair.first.getLSB());
+            this->signalSummary.push_back((pair.second.first ? ResultReader::SUMMARY_DATA : 0) | (pair.second.second ? ResultReader::SUMMARY_SELECT : 0));
+            this->signalWords.push_back((uint32_t)this->dataPlane.size());
+        }
+    }
+    //Condensing
+    else
+    {
+        for( const auto &pair : sliceStructure )
+        {
+            const std::vector<uint64_t> &data = pair.second.getDataPlane();
+            const std::vector<uint64_t> &select = pair.second.getSelectPlane();
+            uint8_t summary = 0;
+
+            for(size_t w = 0; w < data.size(); w++)
+            {
+                summary |= (data[w] != 0 ? ResultReader::SUMMARY_DATA : 0) | (select[w] != 0 ? ResultReader::SUMMARY_SELECT : 0);
+            }
+
+            this->signalNames.push_back(this->intern(pair.first));
+            this->signalMSB.push_back(pair.first.getMSB());
+            this->signalLSB.push_back(pair.first.getLSB());
+            this->signalSummary.push_back(summary);
+            this->dataPlane.insert(this->dataPlane.end(), data.begin(), data.end());
+            this->selectPlane.insert(this->selectPlane.end(), select.begin(), select.end());
+            this->signalWords.push_back((uint32_t)this->dataPlane.size());
+        }
+    }
+
+    this->moduleSignals.push_back((uint32_t)this->signalNames.size());
+}
+
+void ResultWriter::BinaryWriter::end()
+{
+    std::ostream &bin = *this->out;
+
+    //The table is sorted so that readers can look names up with a binary search: ids are remapped to the sorted positions
+    std::vector<uint32_t> order(this->strings.size());
+    for(uint32_t s = 0; s < order.size(); s++)
+    {
+        order[s] = s;
+    }
+
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return this->strings[a] < this->strings[b]; });
+
+    std::vector<uint32_t> rank(order.size());
+    std::vector<uint32_t> stringOffsets;
+    std::string stringData;
+
+    for(uint32_t s = 0; s < order.size(); s++)
+    {
+        rank[order[s]] = s;
+        stringOffsets.push_back((uint32_t)stringData.size());
+        stringData += this->strings[order[s]];
+        stringData += '\0';
+    }
+
+    stringOffsets.push_back((uint32_t)stringData.size());
+
+    for(auto &id : this->moduleNames)
+    {
+        id = rank[id];
+    }
+
+    for(auto &id : this->signalNames)
+    {
+        id = rank[id];
+    }
+
+    //Sections follow the header in the order of ResultReader::Section, the offsets are known in advance
+    std::vector<uint64_t> sizes = {
+        stringOffsets.size() * 4, stringData.size(), this->moduleNames.size() * 4, this->moduleSignals.size() * 4, this->signalNames.size() * 4,
+        this->signalMSB.size() * 4, this->signalLSB.size() * 4, this->signalSummary.size(), this->signalWords.size() * 4,
+        this->dataPlane.size() * 8, this->selectPlane.size() * 8
+    };
+
+    std::vector<uint64_t> offsets;
+    uint64_t position = ResultReader::HEADER_SIZE;
+
+    for(auto size : sizes)
+    {
+        offsets.push_back(position);
+        position += (size + 7) / 8 * 8;
+    }
+
+    bin.write(ResultReader::MAGIC, sizeof(ResultReader::MAGIC));
+    writeLittleEndian(bin, ResultReader::VERSION, 4);
+    writeLittleEndian(bin, this->condense ? ResultReader::FLAG_CONDENSED : 0, 4);
+    writeLittleEndian(bin, this->moduleNames.size(), 4);
+    writeLittleEndian(bin, this->signalNames.size(), 4);
+    writeLittleEndian(bin, this->strings.size(), 4);
+    writeLittleEndian(bin, 0, 4);
+    writeLittleEndian(bin, this->dataPlane.size(), 8);
+
+    for(auto offset : offsets)
+    {
+        writeLittleEndian(bin, offset, 8);
+    }
+
+    position = ResultReader::HEADER_SIZE;
+    position = writeColumn(bin, position, stringOffsets);
+    bin.write(stringData.data(), stringData.size());
+    position = pad(bin, position + stringData.size());
+    position = writeColumn(bin, position, this->moduleNames);
+    position = writeColumn(bin, position, this->moduleSignals);
+    position = writeColumn(bin, position, this->signalNames);
+    position = writeColumn(bin, position, this->signalMSB);
+    position = writeColumn(bin, position, this->signalLSB);
+    position = writeColumn(bin, position, this->signalSummary);
+    position = writeColumn(bin, position, this->signalWords);
+    position = writeColumn(bin, position, this->dataPlane);
+    writeColumn(bin, position, this->selectPlane);
+
+    bin.flush();
+}
@@ -0,0 +1,180 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef RESULT_WRITER_H
+#define RESULT_WRITER_H
+
+//Standard libraries
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+//Application libraries
+#include "signal_library.h"
+#include "slice_planes.h"
+
+namespace ResultWriter
+{
+    /*
+     *  Sink of the report of a run, in one output format. The DesignAnalyzer hands it each module as soon as it is analyzed (in report order)
+     *  and the writer streams it out straight away: nothing of the report is kept in memory besides the buffer of the sink.
+     *  Only the writers of the requested formats are created.
+     */
+    class ResultWriter
+    {
+        private:
+            //Owned file, nullptr when writing to a stream of the caller
+            std::unique_ptr<std::ofstream> file;
+            std::unique_ptr<char[]> fileBuffer;
+
+        protected:
+            std::ostream *out;
+            bool condense;
+
+        public:
+            //Size of the buffer of the file sinks
+            static const size_t FILE_BUFFER_SIZE = 1 << 16;
+
+            /*
+             *  Writes to a stream owned by the caller (e.g. std::cout).
+             */
+            ResultWriter(std::ostream &out, bool condense);
+
+            /*
+             *  Writes to a file, truncated on opening. See isOpen.
+             */
+            ResultWriter(const std::string &filepath, bool condense, bool binary = false);
+
+            virtual ~ResultWriter();
+
+            ResultWriter(const ResultWriter &) = delete;
+            ResultWriter &operator=(const ResultWriter &) = delete;
+
+            bool isOpen() const;
+
+            /*
+             *  Called once before the first module.
+             */
+            virtual void begin();
+
+            /*
+             *  One analyzed module: its DFS_FTSA results, already sorted, or its slice structure when condensing. The title is the name
+             *  as it is shown in the textual reports.
+             */
+            virtual void writeModule(const std::string &moduleName, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                                     const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) = 0;
+
+            /*
+             *  Called once after the last module: closes the document and flushes the sink.
+             */
+            virtual void end();
+    };
+
+    class PlaintextWriter : public ResultWriter
+    {
+        public:
+            using ResultWriter::ResultWriter;
+
+            void writeModule(const std::string &moduleName, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                             const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) override;
+    };
+
+    class XMLWriter : public ResultWriter
+    {
+        public:
+            using ResultWriter::ResultWriter;
+
+            void begin() override;
+            void writeModule(const std::string &moduleName, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                             const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) override;
+            void end() override;
+    };
+
+    class JSONWriter : public ResultWriter
+    {
+        public:
+            using ResultWriter::ResultWriter;
+
+            void writeModule(const std::string &moduleName, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                             const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) override;
+    };
+
+    /*
+     *  Newline-delimited JSON: one compact record per signal (per condensed signal when condensing), flushed at the end of every module.
+     */
+    class NDJSONWriter : public ResultWriter
+    {
+        public:
+            using ResultWriter::ResultWriter;
+
+            void writeModule(const std::string &moduleName, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                             const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) override;
+            void end() override;
+    };
+
+    class CSVWriter : public ResultWriter
+    {
+        public:
+            using ResultWriter::ResultWriter;
+
+            void writeModule(const std::string &moduleName, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                             const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) override;
+    };
+
+    /*
+     *  Binary columnar report, in the layout described in result_reader.h. Columns can only be laid out once every module is known, so
+     *  the rows are gathered as plain integers (names as ids, slices as plane words) and the file is written by end().
+     */
+    class BinaryWriter : public ResultWriter
+    {
+        private:
+            //Strings by id of first use, and the ids of the names seen so far
+            std::vector<std::string> strings;
+            std::unordered_map<std::string, uint32_t> stringIds;
+            //Same, by interned signal name
+            std::unordered_map<int, uint32_t> signalIds;
+
+            std::vector<uint32_t> moduleNames;
+            std::vector<uint32_t> moduleSignals;
+            std::vector<uint32_t> signalNames;
+            std::vector<int32_t> signalMSB;
+            std::vector<int32_t> signalLSB;
+            std::vector<uint8_t> signalSummary;
+            std::vector<uint32_t> signalWords;
+            std::vector<uint64_t> dataPlane;
+            std::vector<uint64_t> selectPlane;
+
+            uint32_t intern(const std::string &text);
+            uint32_t intern(const Signal::Signal &signal);
+
+        public:
+            BinaryWriter(const std::string &filepath, bool condense);
+
+            void writeModule(const std::string &moduleName, const std::string &title, const SlicePlanes::SliceStructure &sliceStructure,
+                             const std::vector< std::pair< Signal::Signal, std::pair<bool, bool> > > &results) override;
+            void end() override;
+    };
+}
+
+#endif
@@ -25,6 +25,7 @@
 #include <string>
 #include <iostream>
 #include <stdexcept>
+#include <map>
 
 //Yosys libraries
 #include "kernel/yosys.h"
@@ -147,6 +148,47 @@ std::pair<bool, std::vector<Signal::Signal>> RTLIL_DUMPER::sigSpecDumper(const R
     return result;
 }
 
+std::vector<Signal::Signal> RTLIL_DUMPER::portSignalDumper(const RTLIL::SigSpec &sig)
+{
+    std::vector<Signal::Signal> signals;
+    
+    //Named wires in order of first appearance, each one with its chunks
+    std::vector<RTLIL::Wire*> wires;
+    std::map<RTLIL::Wire*, std::vector<Signal::Signal>> wireChunks;
+    
+    const std::vector<RTLIL::SigChunk> &chunks = sig.chunks();
+    
+    for(auto it = chunks.rbegin(); it != chunks.rend(); it++)
+    {
+        if((it->wire == NULL) || (it->wire->name.c_str()[0] != '\\'))
+        {
+            continue;
+        }
+        
+        auto found = wireChunks.find(it->wire);
+        
+        if(found == wireChunks.end())
+        {
+            wires.push_back(it->wire);
+            found = wireChunks.insert(std::make_pair(it->wire, std::vector<Signal::Signal>())).first;
+        }
+        
+        Signal::Signal chunkSignal(it->wire->name.str(), (it->width + it->offset -1), it->offset);
+        
+        found->second = VectorSupport::conditionalInsert(found->second, chunkSignal);
+    }
+    
+    for(auto wire : wires)
+    {
+        for(auto &chunkSignal : wireChunks[wire])
+        {
+            signals.push_back(chunkSignal);
+        }
+    }
+    
+    return signals;
+}
+
 std::pair<std::vector<Signal::Signal>,std::vector<Signal::Signal>> RTLIL_DUMPER::connDumper(const RTLIL::SigSpec &left,const RTLIL::SigSpec &right)
 {
     std::pair<std::vector<Signal::Signal>, std::vector<Signal::Signal>> result;
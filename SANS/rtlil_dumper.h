@@ -67,6 +67,15 @@ namespace RTLIL_DUMPER
      */
     std::pair<bool, std::vector<Signal::Signal>> sigSpecDumper(const RTLIL::SigSpec &sig);
     
+    /*
+     * Method used for extracting the signals that a (sigmapped) port connection carries, straight from the SigSpec chunks.
+     * 
+     * Only named wires (public identifiers, the ones beginning with '\\') are kept: constants and internal $-wires are dropped.
+     * The chunks are listed in the same order as sigSpecDumper, but those of the same wire are kept together (wires in order of
+     * first appearance) and repeated chunks are reported once.
+     */
+    std::vector<Signal::Signal> portSignalDumper(const RTLIL::SigSpec &sig);
+    
     /*
      * Method used for converting an a connection among two RTLIL::Cell or modules into a pair of vectors that represents 
      * the chunks associated to such connections.
@@ -18,87 +18,189 @@
  */
 
 #include<stdio.h>
+#include<atomic>
+#include<mutex>
+#include<stdexcept>
+#include<unordered_map>
 #include "signal_library.h"
 #include "kernel/yosys.h"
 
 USING_YOSYS_NAMESPACE
 
-Signal::Signal::Signal(std::string signalName, int MSB, int LSB) : signalName(signalName), dimensionPair(std::make_pair(MSB, LSB)) {}
+namespace
+{
+	/*
+	 *	Interned signal names. The names live in fixed-size blocks that are never moved while the table is in use, so nameOf() reads
+	 *	them without taking the lock: an id can only reach a thread after the name behind it has been stored.
+	 *	The blocks are freed when the last NameScope closes (see clear).
+	 */
+	struct NameTable
+	{
+		static const int BLOCK_BITS = 14;
+		static const int BLOCK_SIZE = 1 << BLOCK_BITS;
+		static const int BLOCKS = 1 << 14;
+
+		std::mutex lock;
+		std::unordered_map<std::string, int> ids;
+		std::atomic<std::string*> blocks[BLOCKS];
+		int count;
+		//Open NameScopes
+		int scopes;
+
+		NameTable() : count(0), scopes(0)
+		{
+			for(int i = 0; i < BLOCKS; i++)
+			{
+				blocks[i].store(nullptr, std::memory_order_relaxed);
+			}
 
-std::string Signal::Signal::getSignalName() const { return this->signalName; }
-std::pair<int, int> Signal::Signal::getDimensionPair() const { return this->dimensionPair; }
-int Signal::Signal::getMSB() const { return this->dimensionPair.first; }
-int Signal::Signal::getLSB() const { return this->dimensionPair.second; }
+			intern(EMPTYSIGNAL);
+		}
 
-bool Signal::Signal::isEmpty()
-{
-	return ( this->signalName == EMPTYSIGNAL ) ? true : false;
-}
+		//Drops every name but EMPTYSIGNAL. Must be called with the lock held, when no id is in use any more
+		void clear()
+		{
+			for(int i = 0; i < BLOCKS; i++)
+			{
+				delete[] blocks[i].load(std::memory_order_relaxed);
+				blocks[i].store(nullptr, std::memory_order_relaxed);
+			}
+
+			ids.clear();
+			count = 0;
+		}
 
-int Signal::Signal::width()
-{
-	return (dimensionPair.first - dimensionPair.second) + 1;
+		//Must be called with the lock held (or from the constructor). -1 when the table is full
+		int intern(const std::string &signalName)
+		{
+			auto found = ids.find(signalName);
+
+			if(found != ids.end())
+			{
+				return found->second;
+			}
+
+			int block = count >> BLOCK_BITS;
+
+			if(block >= BLOCKS)
+			{
+				return -1;
+			}
+
+			if(blocks[block].load(std::memory_order_relaxed) == nullptr)
+			{
+				blocks[block].store(new std::string[BLOCK_SIZE], std::memory_order_release);
+			}
+
+			blocks[block].load(std::memory_order_relaxed)[count & (BLOCK_SIZE - 1)] = signalName;
+			ids.insert(std::make_pair(signalName, count));
+
+			return count++;
+		}
+	};
+
+	NameTable &names()
+	{
+		static NameTable table;
+
+		return table;
+	}
 }
 
-std::string Signal::Signal::toString()
+Signal::NameScope::NameScope()
 {
-	std::stringstream ss;
-
-	ss << signalName << " [" << dimensionPair.first << ":" << dimensionPair.second << "] ";
+	NameTable &table = names();
+	std::lock_guard<std::mutex> guard(table.lock);
 
-	return ss.str();
+	table.scopes++;
 }
 
-bool Signal::isIn( std::vector<Signal> haystack, Signal needle)
+Signal::NameScope::~NameScope()
 {
-	bool isIn = false;
+	NameTable &table = names();
+	std::lock_guard<std::mutex> guard(table.lock);
 
-	for( auto signal : haystack )
+	if(--table.scopes == 0)
 	{
-		//If it's in here, we don't check other elements
-		if( needle == signal )
-		{
-			isIn = true;
-			break;
-		}
+		table.clear();
+		table.intern(EMPTYSIGNAL);
 	}
-	
-	return isIn;
 }
 
-bool Signal::isIn_byNameOnly(std::vector<Signal> haystack, Signal needle)
+int Signal::internName(const std::string &signalName)
 {
-	bool isIn = false;
+	NameTable &table = names();
+	int signalId;
+	{
+		std::lock_guard<std::mutex> guard(table.lock);
+		signalId = table.intern(signalName);
+	}
 
-	for( auto signal : haystack )
+	//Raised outside the lock: the workers hand it to the thread that runs the pass
+	if(signalId < 0)
 	{
-		if( signal.getSignalName() == needle.getSignalName() )
-		{
-			isIn = true;
-			break;
-		}
+		throw std::overflow_error("Too many signal names (" + std::to_string(NameTable::BLOCKS * NameTable::BLOCK_SIZE) + ")");
 	}
 
-	return isIn;
+	return signalId;
+}
+
+int Signal::findName(const std::string &signalName)
+{
+	NameTable &table = names();
+	std::lock_guard<std::mutex> guard(table.lock);
+
+	auto found = table.ids.find(signalName);
+
+	return (found != table.ids.end()) ? found->second : -1;
+}
+
+const std::string &Signal::nameOf(int signalId)
+{
+	NameTable &table = names();
+
+	return table.blocks[signalId >> NameTable::BLOCK_BITS].load(std::memory_order_acquire)[signalId & (NameTable::BLOCK_SIZE - 1)];
+}
+
+Signal::Signal::Signal(const std::string &signalName, int MSB, int LSB) : signalId(internName(signalName)), MSB(MSB), LSB(LSB) {}
+
+const std::string &Signal::Signal::getSignalName() const { return nameOf(this->signalId); }
+std::pair<int, int> Signal::Signal::getDimensionPair() const { return std::make_pair(this->MSB, this->LSB); }
+
+bool Signal::Signal::isEmpty() const
+{
+	return ( this->signalId == 0 ) ? true : false;
+}
+
+int Signal::Signal::width() const
+{
+	return (MSB - LSB) + 1;
+}
+
+std::string Signal::Signal::toString() const
+{
+	std::stringstream ss;
+
+	ss << getSignalName() << " [" << MSB << ":" << LSB << "] ";
+
+	return ss.str();
 }
 
-std::vector<Signal::Signal> Signal::conditionalInsert_checkSignalName(std::vector<Signal> vector, Signal signal)
+bool Signal::isIn( const std::vector<Signal> &haystack, const Signal &needle)
 {
 	bool isIn = false;
-	for( auto sig : vector )
+
+	for( auto &signal : haystack )
 	{
-		if( sig.getSignalName() == signal.getSignalName() )
+		//If it's in here, we don't check other elements
+		if( needle == signal )
 		{
 			isIn = true;
+			break;
 		}
 	}
-
-	if(!isIn)
-	{
-		vector.push_back(signal);
-	}
-
-	return vector;
+	
+	return isIn;
 }
 
 bool Signal::compare(const Signal& sig_1, const Signal& sig_2)
@@ -130,18 +232,3 @@ std::vector<Signal::Signal> Signal::sort(std::vector<Signal> vector)
 	std::sort( vector.begin(), vector.end(), compare );
 	return vector;
 }
-
-
-Signal::Signal Signal::fetchSignal(std::vector<Signal> vec, std::string sigName)
-{
-	for( auto signal : vec )
-	{
-		if( signal.getSignalName() == sigName )
-		{
-			return signal;
-		}
-	}
-
-	Signal empty;
-	return empty;
-}
\ No newline at end of file
@@ -21,6 +21,7 @@
 #define SIGNAL_LIBRARY_H
 
 #include<algorithm>
+#include<functional>
 #include<string>
 #include<vector>
 
@@ -31,74 +32,96 @@ namespace Signal
 	#define EMPTYSIGNAL "Empty"
 
 	/*
-	 *	Struct representing a signal
+	 *	Signal names are interned in a process-wide table and signals only carry their id. EMPTYSIGNAL is always id 0.
+	 *	Interning is thread safe, and so is reading a name back: the stored names never move. A full table throws std::overflow_error.
+	 */
+	int internName(const std::string &signalName);
+
+	/*
+	 *	Keeps the interned names alive. When the last scope is closed the table is emptied, so that the names of a run do not stay
+	 *	around for the rest of the session: signals and ids must not outlive the scopes they were created in.
+	 *	Scopes are opened and closed while no worker is running.
+	 */
+	class NameScope
+	{
+		public:
+			NameScope();
+			~NameScope();
+
+			NameScope(const NameScope &) = delete;
+			NameScope &operator=(const NameScope &) = delete;
+	};
+
+	/*
+	 *	Id of an already interned name, -1 if the name has never been seen (nothing is added to the table)
+	 */
+	int findName(const std::string &signalName);
+
+	/*
+	 *	Name associated to an id returned by internName()
+	 */
+	const std::string &nameOf(int signalId);
+
+	/*
+	 *	Struct representing a signal: interned name and [MSB:LSB], 12 bytes that are copied and compared as plain integers
 	 */
 	class Signal
 	{
 		private:
-			//Name of the signal
-			std::string signalName;
+			//Id of the name of the signal
+			int signalId;
 			//[MSB:LSB]
-			std::pair<int, int> dimensionPair;
+			int MSB;
+			int LSB;
 
 		public:
 			//Constructor
-			Signal() : signalName(EMPTYSIGNAL) {}
-			Signal(std::string signalName, int MSB, int LSB);
+			Signal() : signalId(0), MSB(0), LSB(0) {}
+			Signal(const std::string &signalName, int MSB, int LSB);
+			Signal(int signalId, int MSB, int LSB) : signalId(signalId), MSB(MSB), LSB(LSB) {}
 
 			//Getters
-			std::string getSignalName() const;
+			const std::string &getSignalName() const;
+			int getSignalId() const { return this->signalId; }
 			std::pair<int, int> getDimensionPair() const;
-			int getMSB() const;
-			int getLSB() const;
+			int getMSB() const { return this->MSB; }
+			int getLSB() const { return this->LSB; }
 
 			/*
 			 *	Is the name EMPTYSIGNAL?
 			 */
-			bool isEmpty();
+			bool isEmpty() const;
 
 			/*
 			 *	Return the width of the signal
 			 */
-			int width();
+			int width() const;
 
 			/*
 			 *	toString() interface
 			 */
-			std::string toString();
+			std::string toString() const;
+
+			/*
+			 *	Hash of the signal, used by the hashlib containers (dict<Signal, T>) and by std::hash
+			 */
+			unsigned int hash() const { return Yosys::hashlib::mkhash(Yosys::hashlib::mkhash(this->signalId, this->MSB), this->LSB); }
 
 			/*
 			 *	Comparison between signals
 			 */
 			friend bool operator==(const Signal& sig_1, const Signal& sig_2)
 			{
-				if 	(	(sig_1.getSignalName() == sig_2.getSignalName())
-							&&
-						(sig_1.getLSB() == sig_2.getLSB())
-							&&
-						(sig_1.getMSB() == sig_2.getMSB())
-					)
-				{
-					return true;
-				}
-				return false;
+				return (sig_1.signalId == sig_2.signalId) && (sig_1.LSB == sig_2.LSB) && (sig_1.MSB == sig_2.MSB);
 			}
+
+			friend bool operator!=(const Signal& sig_1, const Signal& sig_2) { return !(sig_1 == sig_2); }
 	};
 
 	/*
 	 *	Checks if the given signal sig is in list
 	 */
-	bool isIn( std::vector<Signal> haystack, Signal needle);
-
-	/*
-	 *	IsIn but checks only the signal name
-	 */
-	bool isIn_byNameOnly(std::vector<Signal> haystack, Signal needle);
-
-	/*
-	 *	Conditionally insert a signal in the vector if name matches
-	 */
-	std::vector<Signal> conditionalInsert_checkSignalName(std::vector<Signal> vector, Signal signal);
+	bool isIn(const std::vector<Signal> &haystack, const Signal &needle);
 
 	/*
 	 *	Comparison between signal. This is used for the sort algorithm during presentation.
@@ -110,11 +133,14 @@ namespace Signal
 	 *	Sort vector of signal.
 	 */
 	std::vector<Signal> sort(std::vector<Signal> vector);
+}
 
-	/*
-	 *	Fetch signal with passed name.
-	 */
-	Signal fetchSignal(std::vector<Signal> vec, std::string sigName);
+namespace std
+{
+	template<> struct hash<Signal::Signal>
+	{
+		size_t operator()(const Signal::Signal &signal) const { return signal.hash(); }
+	};
 }
 
-#endif
\ No newline at end of file
+#endif
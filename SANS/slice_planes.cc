@@ -0,0 +1,132 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Application libraries
+#include "slice_planes.h"
+
+//The AVX2 fill is compiled for its own target and picked at run time, so the plugin does not need -mavx2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define SANS_AVX2_DISPATCH
+#include <immintrin.h>
+
+//ORs the masks into the words [word, lastWord) four at a time, returns the first word left over
+__attribute__((target("avx2"))) static int fillWordsAvx2(uint64_t *dataPlane, uint64_t *selectPlane, int word, int lastWord, uint64_t dataMask, uint64_t selectMask)
+{
+	__m256i dataWide = _mm256_set1_epi64x((long long)dataMask);
+	__m256i selectWide = _mm256_set1_epi64x((long long)selectMask);
+
+	for( ; word + 4 <= lastWord; word += 4 )
+	{
+		__m256i *d = (__m256i *)&dataPlane[word];
+		__m256i *s = (__m256i *)&selectPlane[word];
+
+		_mm256_storeu_si256(d, _mm256_or_si256(_mm256_loadu_si256(d), dataWide));
+		_mm256_storeu_si256(s, _mm256_or_si256(_mm256_loadu_si256(s), selectWide));
+	}
+
+	return word;
+}
+#endif
+
+SlicePlanes::SlicePlanes::SlicePlanes(int width)
+{
+	this->width = width > 0 ? width : 0;
+	this->dataPlane.assign((this->width + WORD_BITS - 1) / WORD_BITS, 0);
+	this->selectPlane.assign(this->dataPlane.size(), 0);
+}
+
+void SlicePlanes::SlicePlanes::mark(int lsb, int msb, std::pair<bool, bool> data_select)
+{
+	if( lsb < 0 )
+	{
+		lsb = 0;
+	}
+
+	if( msb >= this->width )
+	{
+		msb = this->width - 1;
+	}
+
+	if( lsb > msb )
+	{
+		return;
+	}
+
+	//All ones or all zeros, so the flags select the bits without branches
+	uint64_t dataMask = -(uint64_t)data_select.first;
+	uint64_t selectMask = -(uint64_t)data_select.second;
+	int firstWord = lsb / WORD_BITS;
+	int lastWord = msb / WORD_BITS;
+
+	//Partial words at the two ends (the same word if the slice does not cross a boundary)
+	uint64_t firstRange = ~(uint64_t)0 << (lsb % WORD_BITS);
+	uint64_t lastRange = ~(uint64_t)0 >> (WORD_BITS - 1 - msb % WORD_BITS);
+
+	if( firstWord == lastWord )
+	{
+		firstRange &= lastRange;
+	}
+
+	this->dataPlane[firstWord] |= firstRange & dataMask;
+	this->selectPlane[firstWord] |= firstRange & selectMask;
+
+	if( firstWord == lastWord )
+	{
+		return;
+	}
+
+	this->dataPlane[lastWord] |= lastRange & dataMask;
+	this->selectPlane[lastWord] |= lastRange & selectMask;
+
+	//Whole words in between
+	int word = firstWord + 1;
+
+#ifdef SANS_AVX2_DISPATCH
+	//Wide buses: four words of each plane per instruction
+	if( word + 4 <= lastWord && __builtin_cpu_supports("avx2") )
+	{
+		word = fillWordsAvx2(this->dataPlane.data(), this->selectPlane.data(), word, lastWord, dataMask, selectMask);
+	}
+#endif
+
+	for( ; word < lastWord; word++ )
+	{
+		this->dataPlane[word] |= dataMask;
+		this->selectPlane[word] |= selectMask;
+	}
+}
+
+char SlicePlanes::SlicePlanes::getLetter(int bit) const
+{
+	static const char letters[4] = { 'N', 'D', 'S', 'B' };
+
+	return letters[ (int)this->isData(bit) | ((int)this->isSelect(bit) << 1) ];
+}
+
+std::string SlicePlanes::SlicePlanes::toString() const
+{
+	std::string text(this->width, 'N');
+
+	for( int bit = 0; bit < this->width; bit++ )
+	{
+		text[this->width - 1 - bit] = this->getLetter(bit);
+	}
+
+	return text;
+}
@@ -0,0 +1,96 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef SLICE_PLANES_H
+#define SLICE_PLANES_H
+
+//Standard libraries
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+//Application libraries
+#include "signal_library.h"
+
+namespace SlicePlanes
+{
+	/*
+	 *	Per-bit classification of one entering signal, packed in two bit planes of 64 bits per word: bit i of dataPlane/selectPlane tells if
+	 *	bit i of the signal (LSB first) has been seen as data/select. The letter of a bit (NONE, DATA, SELECT, BOTH) is just the pair of its
+	 *	two plane bits and can only grow, so every update is a word OR and the letters are only rendered for the output.
+	 */
+	class SlicePlanes
+	{
+		private:
+			int width = 0;
+			std::vector<uint64_t> dataPlane;
+			std::vector<uint64_t> selectPlane;
+
+		public:
+			//Bits of a plane word
+			static const int WORD_BITS = 64;
+
+			/*
+			 *	All the bits start as NONE.
+			 */
+			SlicePlanes(int width = 0);
+
+			int size() const { return this->width; }
+
+			/*
+			 *	Adds data_select to the bits [lsb, msb] (clipped to the width), a whole word at a time (four with AVX2 on wide buses)
+			 *	and without branching on the letters.
+			 */
+			void mark(int lsb, int msb, std::pair<bool, bool> data_select);
+
+			/*
+			 *	Plane words, LSB first: bits past the width are always zero.
+			 */
+			const std::vector<uint64_t> &getDataPlane() const { return this->dataPlane; }
+			const std::vector<uint64_t> &getSelectPlane() const { return this->selectPlane; }
+
+			bool isData(int bit) const { return (this->dataPlane[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1; }
+			bool isSelect(int bit) const { return (this->selectPlane[bit / WORD_BITS] >> (bit % WORD_BITS)) & 1; }
+
+			/*
+			 *	Letter of a bit: 'N', 'D', 'S' or 'B'.
+			 */
+			char getLetter(int bit) const;
+
+			/*
+			 *	Letters of all the bits, MSB first as they are printed.
+			 */
+			std::string toString() const;
+
+			friend bool operator==(const SlicePlanes &a, const SlicePlanes &b)
+			{
+				return a.width == b.width && a.dataPlane == b.dataPlane && a.selectPlane == b.selectPlane;
+			}
+
+			friend bool operator!=(const SlicePlanes &a, const SlicePlanes &b) { return !(a == b); }
+	};
+
+	/*
+	 *	Slice structure of a module: the planes of each entering signal, in the order of Generator::getEnteringSignals.
+	 */
+	typedef std::vector< std::pair< Signal::Signal, SlicePlanes > > SliceStructure;
+}
+
+#endif
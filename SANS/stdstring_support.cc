@@ -385,4 +385,31 @@ std::string StringSupport::DUMP_vector(std::vector< std::pair<std::string, std::
 	ss << "\n";
 
 	return ss.str();
-}
\ No newline at end of file
+}
+
+std::string StringSupport::jsonEscape(const std::string &text)
+{
+	static const char hex[] = "0123456789abcdef";
+	std::string escaped;
+
+	for(char c : text)
+	{
+		if(c == '"' || c == '\\')
+		{
+			escaped += '\\';
+			escaped += c;
+		}
+		else if((unsigned char)c < 0x20)
+		{
+			escaped += "\\u00";
+			escaped += hex[(c >> 4) & 0xF];
+			escaped += hex[c & 0xF];
+		}
+		else
+		{
+			escaped += c;
+		}
+	}
+
+	return escaped;
+}
@@ -143,6 +143,11 @@ namespace StringSupport
 	 *	Returns a string representation of the string vector.
 	 */
 	std::string DUMP_vector(std::vector< std::pair<std::string, std::string> > vec, bool dividePrint=false);
+
+	/*
+	 *	Text to put inside a JSON string: RTLIL names start with a backslash and may hold quotes or control characters.
+	 */
+	std::string jsonEscape(const std::string &text);
 }
 
 #endif
\ No newline at end of file
@@ -20,21 +20,29 @@
 #include "supportGraph.h"
 
 CellRepository::CellRepository* SupportGraph::SupportGraph::getCellRepository() { return this->cr; }
-std::vector<Graph_Node::Node *> SupportGraph::SupportGraph::getNodes() { return this->nodes; }
+const std::vector<Graph_Node::Node *> &SupportGraph::SupportGraph::getNodes() const { return this->nodes; }
 int SupportGraph::SupportGraph::getNumOfNodes() { return this->numOfNodes; }
 
+std::size_t SupportGraph::SupportGraph::getStorageBytes() const { return this->nodeArena.capacityBytes() + this->portArena.capacityBytes(); }
+
 Graph_Node::Node* SupportGraph::SupportGraph::getNode(int id)
 {
-	for( auto node : this->nodes )
+	if( id >= 0 && id < (int)this->nodeById.size() && this->nodeById[id] >= 0 )
 	{
-		if( node->getId() == id )
-		{
-			return node;
-		}
+		return this->nodes[ this->nodeById[id] ];
 	}
 
-	Graph_Node::Node* errorNode = new Graph_Node::Node(-1, "Error_Node", "Error_Node");
-	return errorNode;
+	return &this->errorNode;
+}
+
+Graph_Node::Node* SupportGraph::SupportGraph::createNode(int nodeId, std::string nodeName, std::string nodeType, bool modulePlaceholder)
+{
+	return this->nodeArena.create(nodeId, std::move(nodeName), std::move(nodeType), modulePlaceholder);
+}
+
+Graph_Port::Port* SupportGraph::SupportGraph::createPort(std::string portName, int portId)
+{
+	return this->portArena.create(std::move(portName), portId);
 }
 
 bool SupportGraph::SupportGraph::isNodeName( std::string name )
@@ -60,12 +68,221 @@ int SupportGraph::SupportGraph::addNode(Graph_Node::Node *newNode)
 		}
 	}
 
+	//Ids are dense (they come from the subcircuit graph), the first node with a given id wins as the linear search did
+	if( newNode->getId() >= 0 )
+	{
+		if( newNode->getId() >= (int)this->nodeById.size() )
+		{
+			this->nodeById.resize(newNode->getId() + 1, -1);
+		}
+
+		if( this->nodeById[newNode->getId()] < 0 )
+		{
+			this->nodeById[newNode->getId()] = (int)this->nodes.size();
+		}
+	}
+
 	this->nodes.push_back(newNode);
 	this->numOfNodes++;
+	//The edge index no longer describes the whole graph.
+	this->edgeIndexReady = false;
 
 	return 1;
 }
 
+void SupportGraph::SupportGraph::buildEdgeIndex()
+{
+	std::vector<int> consumerCount;
+
+	//First pass: count how many input ports each edge reaches.
+	for( auto node : this->nodes )
+	{
+		for( auto inputPort : node->getInputs() )
+		{
+			for( auto inputEdge : inputPort->getEdges() )
+			{
+				if( inputEdge >= (int)consumerCount.size() )
+				{
+					consumerCount.resize(inputEdge + 1, 0);
+				}
+				consumerCount[inputEdge]++;
+			}
+		}
+	}
+
+	this->edgeOffsets.assign(consumerCount.size() + 1, 0);
+	for( int e=0; e<(int)consumerCount.size(); e++ )
+	{
+		this->edgeOffsets[e+1] = this->edgeOffsets[e] + consumerCount[e];
+	}
+
+	//Second pass: fill the slots, the role of each port is resolved here once and for all.
+	this->edgeConsumers.assign(this->edgeOffsets.back(), EdgeConsumer());
+	std::vector<int> cursor(this->edgeOffsets.begin(), this->edgeOffsets.end() - 1);
+
+	for( auto node : this->nodes )
+	{
+		for( auto inputPort : node->getInputs() )
+		{
+			ConsumerRole role = DATA_CONSUMER;
+
+			if( node->isModulePlaceholder() )
+			{
+				role = PLACEHOLDER_CONSUMER;
+			}
+			else if( cr->isSelectionPort(node->getType(), inputPort->getPortName()) )
+			{
+				role = SELECTION_CONSUMER;
+			}
+
+			for( auto inputEdge : inputPort->getEdges() )
+			{
+				EdgeConsumer &slot = this->edgeConsumers[ cursor[inputEdge]++ ];
+				slot.node = node;
+				slot.port = inputPort;
+				slot.role = role;
+			}
+		}
+	}
+
+	//Node-level view: for each node, what its outputs reach, without duplicates.
+	this->nodeIdBound = 0;
+	for( auto node : this->nodes )
+	{
+		this->nodeIdBound = std::max(this->nodeIdBound, node->getId() + 1);
+	}
+
+	std::vector< std::vector<EdgeConsumer> > perNode(this->nodeIdBound);
+
+	for( auto node : this->nodes )
+	{
+		if( node->getId() < 0 )
+		{
+			continue;
+		}
+
+		std::set< std::pair<Graph_Node::Node *, Graph_Port::Port *> > seen;
+
+		for( auto outputPort : node->getOutputs() )
+		{
+			for( auto outputEdge : outputPort->getEdges() )
+			{
+				if( outputEdge + 1 >= (int)this->edgeOffsets.size() )
+				{
+					continue;
+				}
+
+				for( int i=this->edgeOffsets[outputEdge]; i<this->edgeOffsets[outputEdge+1]; i++ )
+				{
+					const EdgeConsumer &consumer = this->edgeConsumers[i];
+
+					if( consumer.node != node && seen.insert(std::make_pair(consumer.node, consumer.port)).second )
+					{
+						perNode[node->getId()].push_back(consumer);
+					}
+				}
+			}
+		}
+	}
+
+	this->successorOffsets.assign(this->nodeIdBound + 1, 0);
+	this->successors.clear();
+	for( int n=0; n<this->nodeIdBound; n++ )
+	{
+		this->successors.insert(this->successors.end(), perNode[n].begin(), perNode[n].end());
+		this->successorOffsets[n+1] = (int)this->successors.size();
+	}
+
+	this->edgeIndexReady = true;
+}
+
+SupportGraph::EdgeConsumerRange SupportGraph::SupportGraph::edgeConsumersOf(int edgeId)
+{
+	EdgeConsumerRange range;
+
+	if( !this->edgeIndexReady )
+	{
+		this->buildEdgeIndex();
+	}
+
+	if( edgeId < 0 || edgeId + 1 >= (int)this->edgeOffsets.size() )
+	{
+		range.first = range.last = nullptr;
+		return range;
+	}
+
+	range.first = this->edgeConsumers.data() + this->edgeOffsets[edgeId];
+	range.last = this->edgeConsumers.data() + this->edgeOffsets[edgeId + 1];
+	return range;
+}
+
+SupportGraph::EdgeConsumerRange SupportGraph::SupportGraph::successorsOf(Graph_Node::Node *node)
+{
+	EdgeConsumerRange range;
+
+	if( !this->edgeIndexReady )
+	{
+		this->buildEdgeIndex();
+	}
+
+	int id = node->getId();
+
+	if( id < 0 || id >= this->nodeIdBound )
+	{
+		range.first = range.last = nullptr;
+		return range;
+	}
+
+	range.first = this->successors.data() + this->successorOffsets[id];
+	range.last = this->successors.data() + this->successorOffsets[id + 1];
+	return range;
+}
+
+int SupportGraph::SupportGraph::getNodeIdBound()
+{
+	if( !this->edgeIndexReady )
+	{
+		this->buildEdgeIndex();
+	}
+
+	return this->nodeIdBound;
+}
+
+bool SupportGraph::SupportGraph::isSelectionConsumer(Graph_Node::Node *sourceNode, const EdgeConsumer &consumer)
+{
+	switch( consumer.role )
+	{
+		case SELECTION_CONSUMER:
+			return true;
+
+		case PLACEHOLDER_CONSUMER:
+		{
+			bool selectionPort = false;
+
+			for( auto selectionInput : sourceNode->getModuleSelectionPorts() )
+			{
+				if( selectionInput->getPortName() == consumer.port->getPortName() )
+				{
+					selectionPort = true;
+
+					for( auto dataInput : sourceNode->getModuleDataPorts() )
+					{
+						if( dataInput->getPortName() == selectionInput->getPortName() )
+						{
+							selectionPort = false;
+						}
+					}
+				}
+			}
+
+			return selectionPort;
+		}
+
+		default:
+			return false;
+	}
+}
+
 std::vector<Graph_Node::Node *> SupportGraph::SupportGraph::nextNodes(Graph_Node::Node *node, Graph_Port::Port *port, bool discriminating, bool verbose)
 {
 	std::vector<Graph_Node::Node *> next;
@@ -85,81 +302,34 @@ std::vector<Graph_Node::Node *> SupportGraph::SupportGraph::nextNodes(Graph_Node
 		//We match the right port of the node
 		if( outputPort->getPortName() == port->getPortName() )
 		{
-			//For each one of the edges connected to this port, I've to retrieve the other end of the edge.
+			//For each one of the edges connected to this port, the index already knows the other ends of the edge.
 			for( auto outputEdge : outputPort->getEdges() )
 			{
-				//Check each node
-				for( auto otherNode : getNodes() )
+				for( const EdgeConsumer &consumer : this->edgeConsumersOf(outputEdge) )
 				{
 					//We need this, otherwise we find ourselves while searching for other nodes.
-					if( node->getName() != otherNode->getName() )
+					if( consumer.node == node )
 					{
-						//And each input port
-						for( auto inputPort : otherNode->getInputs() )
-						{
-							for( auto inputEdge : inputPort->getEdges() )
-							{
-								//We've found a matching edge in another node
-								if(outputEdge == inputEdge)
-								{
-									//If we're discriminating between selection and communication, then execute this block.
-									if(discriminating)
-									{
-										/*  
-										 *	If the input port corresponds to a selection signal, we do not need it since we're explicitly
-										 *	discriminating between selection and communication signals.
-										 */		
-										bool selectionPort = false;
-                                        
-                                        if(!otherNode->isModulePlaceholder())
-                                        {
-                                            if( VectorSupport::isIn( (cr->getCell(otherNode->getType()))->getSelectionInputs(), inputPort->getPortName() ) )
-                                            {
-                                                selectionPort = true;
-                                            }
-                                        }
-                                        else
-                                        {
-                                            for(auto selectionInput : node->getModuleSelectionPorts())
-                                            {
-                                                if(selectionInput->getPortName() == inputPort->getPortName())
-                                                {
-                                                    selectionPort = true;
-                                                    
-                                                    for(auto dataInput : node->getModuleDataPorts())
-                                                    {
-                                                        if(dataInput->getPortName() == selectionInput->getPortName())
-                                                        {
-                                                            selectionPort = false;
-                                                        }
-                                                    }
-                                                    
-                                                }
-                                            }
-                                        }
-
-										if(!selectionPort)
-										{
-											next = VectorSupport::conditionalInsert(next, otherNode);
-
-											if(verbose)
-											{
-												ss << "\tMatched edge: " << outputEdge << " of node " << node->getName() << " port: " << inputPort->getPortName() << "\n";
-											}
-										}
-									}
-									else
-									{
-										next = VectorSupport::conditionalInsert(next, otherNode);
-
-										if(verbose)
-										{
-											ss << "\tMatched edge: " << outputEdge << " of node " << node->getName() << " port: " << inputPort->getPortName() << "\n";
-										}
-									}
-								}
-							}
-						}
+						continue;
+					}
+
+					/*
+					 *	If we're discriminating between selection and communication and the input port corresponds to a selection signal,
+					 *	we do not need it.
+					 */
+					if( discriminating && this->isSelectionConsumer(node, consumer) )
+					{
+						continue;
+					}
+
+					if( std::find(next.begin(), next.end(), consumer.node) == next.end() )
+					{
+						next.push_back(consumer.node);
+					}
+
+					if(verbose)
+					{
+						ss << "\tMatched edge: " << outputEdge << " of node " << node->getName() << " port: " << consumer.port->getPortName() << "\n";
 					}
 				}
 			}
@@ -192,7 +362,7 @@ std::vector<Graph_Node::Node *> SupportGraph::SupportGraph::allNextNodes(Graph_N
 	for( auto outputPort : node->getOutputs() )
 	{
 		std::vector<Graph_Node::Node *> appendable = nextNodes(node, outputPort, discriminating);
-		reachable = VectorSupport::append(reachable, appendable);
+		reachable.insert( reachable.end(), appendable.begin(), appendable.end() );
 	}
 
 	if(verbose)
@@ -217,23 +387,24 @@ std::vector< std::pair<Graph_Port::Port *, int> > SupportGraph::SupportGraph::re
 	for( auto dstPort : dstNode->getInputs() )
 	{
 		temp.push_back( std::make_pair(dstPort, 0) );
-		//And all the edges connected to each port
-		for( auto inputEdge : dstPort->getEdges() )
+	}
+
+	//Foreach edge that exits from my port, count the bits landing in each port of the destination node
+	for( auto outputEdge : sourcePort->getEdges() )
+	{
+		for( const EdgeConsumer &consumer : this->edgeConsumersOf(outputEdge) )
 		{
-			//Foreach edge that exits from my port
-			for( auto outputEdge : sourcePort->getEdges() )
+			if( consumer.node != dstNode )
+			{
+				continue;
+			}
+
+			//Pairs are intended as values, the auto& forces the reference
+			for( auto& pair : temp )
 			{
-				//If one of my edges matches one of its edges
-				if( outputEdge == inputEdge )
+				if( pair.first == consumer.port )
 				{
-					//Pairs are intended as values, the auto& forces the reference
-					for( auto& pair : temp )
-					{
-						if( pair.first->getPortName() == dstPort->getPortName() )
-						{
-							pair.second++;
-						}
-					}
+					pair.second++;
 				}
 			}
 		}
@@ -21,6 +21,7 @@
 #define SUPPORT_H
 
 //Application libraries
+#include "arena.h"
 #include "node_library.h"
 #include "stdvector_support.h"
 #include "cellrepo.h"
@@ -29,6 +30,43 @@ USING_YOSYS_NAMESPACE
 
 namespace SupportGraph
 {
+	/*
+	 *	Role of an input port reached through an edge.
+	 */
+	enum ConsumerRole
+	{
+		//The port is a data input of an atomic cell
+		DATA_CONSUMER = 0,
+		//The port is a selection input of an atomic cell
+		SELECTION_CONSUMER = 1,
+		//The port belongs to a module placeholder, its role is known only after the inner module has been analyzed
+		PLACEHOLDER_CONSUMER = 2
+	};
+
+	/*
+	 *	Single entry of the edge index: <node, port> pair where an edge ends, together with the role of the port.
+	 */
+	struct EdgeConsumer
+	{
+		Graph_Node::Node *node;
+		Graph_Port::Port *port;
+		ConsumerRole role;
+	};
+
+	/*
+	 *	Lightweight view over the consumers of a single edge. It does not own anything, so it is valid until the index is rebuilt.
+	 */
+	struct EdgeConsumerRange
+	{
+		const EdgeConsumer *first;
+		const EdgeConsumer *last;
+
+		const EdgeConsumer *begin() const { return first; }
+		const EdgeConsumer *end() const { return last; }
+		bool empty() const { return first == last; }
+		int size() const { return (int)(last - first); }
+	};
+
 	/*
 	 *	The graph represented by this class is the one containing all infos needed.
 	 */
@@ -36,20 +74,55 @@ namespace SupportGraph
 	{
 		private:
 			//Tech repository to distinguish between data and selection signals.
-			CellRepository::CellRepository *cr = new CellRepository::CellRepository();
+			CellRepository::CellRepository *cr = CellRepository::CellRepository::getInstance();
 			//Node list.
 			std::vector<Graph_Node::Node *> nodes;
 			//Count of the nodes. Incremented each time a node is added.
 			int numOfNodes = 0;		
+			//Storage of the nodes and ports built by createNode/createPort: they belong to the graph and are freed all together with it.
+			Arena::Arena<Graph_Node::Node> nodeArena;
+			Arena::Arena<Graph_Port::Port> portArena;
+			//Position in the node list of each node id, -1 where no node has that id.
+			std::vector<int> nodeById;
+			//Returned by getNode for unknown ids.
+			Graph_Node::Node errorNode{-1, "Error_Node", "Error_Node"};
+
+			/*
+			 *	Edge index (CSR layout). The consumers of edge e are edgeConsumers[ edgeOffsets[e] .. edgeOffsets[e+1] ).
+			 *	Consumers of each edge keep the order of the node list first and of the input ports then.
+			 */
+			std::vector<int> edgeOffsets;
+			std::vector<EdgeConsumer> edgeConsumers;
+			/*
+			 *	Same layout keyed by node id: every <node, port> reached by any output of the node, each pair once and the node itself excluded.
+			 */
+			std::vector<int> successorOffsets;
+			std::vector<EdgeConsumer> successors;
+			//Greatest node id plus one, used to size id-indexed structures.
+			int nodeIdBound = 0;
+			//False until the index is built, reset each time a node is added.
+			bool edgeIndexReady = false;
+
 
 		public:
+			SupportGraph() {}
+
+			//Nodes and ports live in the graph's arenas, a copy would point into storage it does not own
+			SupportGraph(const SupportGraph &) = delete;
+			SupportGraph &operator=(const SupportGraph &) = delete;
+
 			//Getters
 			CellRepository::CellRepository* getCellRepository();
-			std::vector<Graph_Node::Node *> getNodes();
+			const std::vector<Graph_Node::Node *> &getNodes() const;
 			int getNumOfNodes();
 
 			/*
-			 *	Get node from its id
+			 *	Bytes reserved for the nodes and ports of the graph (their containers excluded).
+			 */
+			std::size_t getStorageBytes() const;
+
+			/*
+			 *	Get node from its id. Unknown ids give back an error node (id -1) owned by the graph.
 			 */
 			Graph_Node::Node* getNode(int id);
 
@@ -58,11 +131,44 @@ namespace SupportGraph
 			 */
 			bool isNodeName( std::string name );
 
+			/*
+			 *	Build a node (or a port) in the storage of the graph. The node still has to be added with addNode.
+			 */
+			Graph_Node::Node* createNode(int nodeId, std::string nodeName, std::string nodeType, bool modulePlaceholder = false);
+			Graph_Port::Port* createPort(std::string portName, int portId);
+
 			/*
 			 *	Add a node to the node list. Also increment the node count.
 			 */
 			int addNode(Graph_Node::Node *newNode);
 
+			/*
+			 *	Build the edge index mapping each edge to the input ports it reaches. Called once the graph is complete (see Generator::buildConsistentGraph),
+			 *	queries rebuild it on their own if nodes were added in the meantime.
+			 */
+			void buildEdgeIndex();
+
+			/*
+			 *	All the <node, port> pairs reached by an edge. Empty range for unknown edges.
+			 */
+			EdgeConsumerRange edgeConsumersOf(int edgeId);
+
+			/*
+			 *	All the <node, port> pairs reached by the outputs of a node (the node itself is excluded). Empty range for unknown nodes.
+			 */
+			EdgeConsumerRange successorsOf(Graph_Node::Node *node);
+
+			/*
+			 *	Upper bound (exclusive) of the node ids, to size visited vectors and similar.
+			 */
+			int getNodeIdBound();
+
+			/*
+			 *	Resolve the role of a port that is reached coming from sourceNode. Placeholders are resolved here since their module ports are
+			 *	set only after the analysis of the inner module.
+			 */
+			bool isSelectionConsumer(Graph_Node::Node *sourceNode, const EdgeConsumer &consumer);
+
 			/*
 			 *	Given a node and a port, find out what's reachable forwards.
 			 */
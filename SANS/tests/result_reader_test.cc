@@ -0,0 +1,270 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+/*
+ *  Round trip of the binary report: the rows read back from a file written by sans -bin must render exactly as the NDJSON report of
+ *  the same run (sans -bin <file> -ndjson), then damaged copies of the file must be rejected. Only the standard library is needed,
+ *  run_tests.sh produces the two reports with yosys.
+ *
+ *  Usage: result_reader_test <report.bin> <report.ndjson>
+ */
+
+//Standard libraries
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+//Application libraries
+#include "../result_reader.h"
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        if(!condition)
+        {
+            std::printf("FAILED: %s\n", what.c_str());
+            failures++;
+        }
+    }
+
+    //Same escaping as StringSupport::jsonEscape
+    std::string jsonEscape(const std::string &text)
+    {
+        static const char hex[] = "0123456789abcdef";
+        std::string escaped;
+
+        for(char c : text)
+        {
+            if(c == '"' || c == '\\')
+            {
+                escaped += '\\';
+                escaped += c;
+            }
+            else if((unsigned char)c < 0x20)
+            {
+                escaped += "\\u00";
+                escaped += hex[(c >> 4) & 0xF];
+                escaped += hex[c & 0xF];
+            }
+            else
+            {
+                escaped += c;
+            }
+        }
+
+        return escaped;
+    }
+
+    /*
+     *  Row of the reader as NDJSONWriter prints it.
+     */
+    std::string render(const ResultReader::ResultReader &reader, uint32_t m, uint32_t r)
+    {
+        std::string line = "{\"module\":\"" + jsonEscape(reader.getModuleName(m).toString()) + "\",\"signal\":\""
+                           + jsonEscape(reader.getSignalName(r).toString()) + "\",\"msb\":" + std::to_string(reader.getMSB(r))
+                           + ",\"lsb\":" + std::to_string(reader.getLSB(r));
+
+        if(!reader.isCondensed())
+        {
+            return line + ",\"data\":" + (reader.isData(r) ? "true" : "false") + ",\"select\":" + (reader.isSelect(r) ? "true" : "false") + "}";
+        }
+
+        static const char letters[4] = { 'N', 'D', 'S', 'B' };
+        int width = reader.getMSB(r) - reader.getLSB(r) + 1;
+        std::string slice(width, 'N');
+        bool data = false, select = false;
+
+        for(int bit = 0; bit < width; bit++)
+        {
+            data |= reader.isDataBit(r, bit);
+            select |= reader.isSelectBit(r, bit);
+            slice[width - 1 - bit] = letters[(int)reader.isDataBit(r, bit) | ((int)reader.isSelectBit(r, bit) << 1)];
+        }
+
+        check(reader.wordCount(r) == (uint32_t)(width + 63) / 64, "row " + std::to_string(r) + " has one plane word every 64 bits");
+        check(reader.isData(r) == data && reader.isSelect(r) == select, "the summary of row " + std::to_string(r) + " matches its planes");
+
+        return line + ",\"slice\":\"" + slice + "\"}";
+    }
+
+    void roundTrip(const ResultReader::ResultReader &reader, const std::vector<std::string> &lines)
+    {
+        size_t line = 0;
+
+        for(uint32_t m = 0; m < reader.moduleCount(); m++)
+        {
+            std::string module = reader.getModuleName(m).toString();
+            check(reader.findModule(module) == m, "module " + module + " is found by name");
+
+            for(uint32_t r = reader.firstSignal(m); r < reader.endSignal(m); r++, line++)
+            {
+                std::string row = render(reader, m, r);
+                check(line < lines.size() && lines[line] == row, "row " + std::to_string(r) + " reads back as written: " + row);
+
+                //findSignal gives the first row of the name
+                std::string signal = reader.getSignalName(r).toString();
+                uint32_t found = reader.findSignal(m, signal);
+                check(found != ResultReader::NOT_FOUND && found <= r && reader.getSignalName(found) == signal,
+                      "signal " + signal + " of module " + module + " is found by name");
+            }
+        }
+
+        check(line == lines.size(), "the binary report has as many rows as the NDJSON one");
+
+        //Names around the ones of the table: a prefix, an extension or a name with a NUL inside only match a string that is exactly them
+        auto exact = [&](const std::string &name)
+        {
+            uint32_t found = reader.findModule(name);
+            return found == ResultReader::NOT_FOUND || reader.getModuleName(found) == name;
+        };
+
+        check(exact(""), "the empty name only matches itself");
+
+        for(uint32_t m = 0; m < reader.moduleCount(); m++)
+        {
+            std::string module = reader.getModuleName(m).toString();
+            check(exact(module + "~") && exact(module.substr(0, module.size() - 1)) && exact(module + std::string(1, '\0') + "x"),
+                  "the names around " + module + " only match themselves");
+        }
+    }
+
+    uint32_t readU32(const std::vector<uint64_t> &file, size_t offset)
+    {
+        uint32_t value;
+        std::memcpy(&value, reinterpret_cast<const char *>(file.data()) + offset, 4);
+        return value;
+    }
+
+    void writeU32(std::vector<uint64_t> &file, size_t offset, uint32_t value)
+    {
+        std::memcpy(reinterpret_cast<char *>(file.data()) + offset, &value, 4);
+    }
+
+    uint64_t sectionOffset(const std::vector<uint64_t> &file, int s)
+    {
+        uint64_t value;
+        std::memcpy(&value, reinterpret_cast<const char *>(file.data()) + ResultReader::OFFSET_SECTIONS + 8 * s, 8);
+        return value;
+    }
+
+    /*
+     *  Copies of the file with one damaged field each: the reader has to refuse all of them.
+     */
+    void damaged(const std::vector<uint64_t> &file, size_t size)
+    {
+        ResultReader::ResultReader reader(file.data(), size);
+        uint32_t modules = reader.moduleCount();
+        uint32_t signals = reader.signalCount();
+        uint32_t strings = readU32(file, ResultReader::OFFSET_STRINGS);
+
+        auto rejects = [&](size_t offset, uint32_t value, const std::string &what)
+        {
+            std::vector<uint64_t> copy = file;
+            writeU32(copy, offset, value);
+            check(!ResultReader::ResultReader(copy.data(), size).isValid(), "a report with " + what + " is rejected");
+        };
+
+        check(!ResultReader::ResultReader(file.data(), size - 1).isValid(), "a truncated report is rejected");
+        rejects(ResultReader::OFFSET_VERSION, ResultReader::VERSION + 1, "another version");
+
+        uint64_t offsets = sectionOffset(file, ResultReader::STRING_OFFSETS);
+        rejects(offsets + 4 * strings, 0xFFFFFF00, "a string table past the end of the file");
+
+        if(strings > 1)
+        {
+            rejects(offsets + 4, readU32(file, offsets + 8), "an empty string");
+            rejects(offsets + 4, readU32(file, offsets + 8) + 1, "decreasing string offsets");
+            rejects(offsets + 4, readU32(file, offsets + 4) + 1, "a string without its terminator");
+        }
+
+        if(modules > 0)
+        {
+            rejects(sectionOffset(file, ResultReader::MODULE_NAME) + 4 * (modules - 1), strings, "a module name outside the string table");
+            rejects(sectionOffset(file, ResultReader::MODULE_SIGNALS), 1, "module rows not starting at 0");
+            rejects(sectionOffset(file, ResultReader::MODULE_SIGNALS) + 4 * modules, signals + 1, "module rows past the last signal");
+        }
+
+        if(modules > 1 && signals > 0)
+        {
+            rejects(sectionOffset(file, ResultReader::MODULE_SIGNALS) + 4, signals + 1, "decreasing module rows");
+        }
+
+        if(signals > 0)
+        {
+            rejects(sectionOffset(file, ResultReader::SIGNAL_NAME) + 4 * (signals - 1), 0xFFFFFFFF, "a signal name outside the string table");
+            rejects(sectionOffset(file, ResultReader::SIGNAL_WORDS) + 4 * signals, readU32(file, sectionOffset(file, ResultReader::SIGNAL_WORDS) + 4 * signals) + 1,
+                    "plane words past the planes");
+        }
+
+        if(signals > 1 && reader.isCondensed())
+        {
+            rejects(sectionOffset(file, ResultReader::SIGNAL_WORDS) + 4, 0xFFFFFFFF, "decreasing plane words");
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if(argc != 3)
+    {
+        std::printf("Usage: %s <report.bin> <report.ndjson>\n", argv[0]);
+        return 2;
+    }
+
+    std::ifstream bin(argv[1], std::ios::binary | std::ios::ate);
+    std::ifstream ndjson(argv[2]);
+
+    if(!bin || !ndjson)
+    {
+        std::printf("Cannot open the reports\n");
+        return 2;
+    }
+
+    //Kept in 64 bit words: the reader wants the buffer aligned to 8 bytes
+    size_t size = (size_t)bin.tellg();
+    std::vector<uint64_t> file((size + 7) / 8, 0);
+    bin.seekg(0);
+    bin.read(reinterpret_cast<char *>(file.data()), size);
+
+    std::vector<std::string> lines;
+    for(std::string line; std::getline(ndjson, line); )
+    {
+        lines.push_back(line);
+    }
+
+    ResultReader::ResultReader reader(file.data(), size);
+    check(reader.isValid(), "the binary report is valid");
+
+    if(reader.isValid())
+    {
+        roundTrip(reader, lines);
+        damaged(file, size);
+
+        ResultReader::MappedResults mapped(argv[1]);
+        check(mapped.reader().isValid() && mapped.reader().signalCount() == reader.signalCount(), "the mapped report reads the same");
+    }
+
+    std::printf("result_reader_test: %s: %s\n", argv[1], failures == 0 ? "all checks passed" : (std::to_string(failures) + " checks failed").c_str());
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# Builds and runs the checks of SANS. The ones that need Yosys (yosys and yosys-config in PATH) are skipped without it.
+cd "$(dirname "$0")" || exit 1
+mkdir -p build
+
+g++ -std=c++11 -O1 -Wall -Wextra -pthread -o build/thread_pool_test thread_pool_test.cc ../thread_pool.cc || exit 1
+./build/thread_pool_test || exit 1
+
+g++ -std=c++11 -O1 -Wall -Wextra -o build/result_reader_test result_reader_test.cc || exit 1
+
+if ! command -v yosys > /dev/null || ! command -v yosys-config > /dev/null; then
+    echo "yosys not found in PATH: skipping the round trip of the binary report"
+    exit 0
+fi
+
+if [ ! -f ../pass.so ]; then
+    (cd .. && yosys-config --build pass.so *.cc) || exit 1
+fi
+
+# Signals wider than 64 bits, so that the slices take more than one plane word
+g++ -O2 -std=c++11 -o build/gen_bench ../../Verilog/Benchmark/gen_bench.cc || exit 1
+./build/gen_bench mixed 2000 -w 80 > build/roundtrip.v || exit 1
+
+for condense in "" "-condense"; do
+    rm -rf build/OUTPUT && mkdir -p build/OUTPUT
+    (cd build && yosys -q -m ../../pass.so -p "read_verilog roundtrip.v; proc; sans -nout $condense -ndjson -bin roundtrip.bin") > build/roundtrip.log 2>&1 \
+        || { echo "sans failed, see build/roundtrip.log"; exit 1; }
+    ./build/result_reader_test build/roundtrip.bin build/OUTPUT/sans.ndjson || exit 1
+done
@@ -0,0 +1,224 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+/*
+ *  Checks of ThreadPool::runGraph: dependency order, cycles and failing tasks, on one and on several workers.
+ *  Only the standard library is needed (see run_tests.sh).
+ */
+
+//Standard libraries
+#include <atomic>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+//Application libraries
+#include "../thread_pool.h"
+
+namespace
+{
+    int failures = 0;
+
+    void check(bool condition, const std::string &what)
+    {
+        if(!condition)
+        {
+            std::printf("FAILED: %s\n", what.c_str());
+            failures++;
+        }
+    }
+
+    struct Dag
+    {
+        std::vector< std::vector<int> > dependents;
+        std::vector<int> dependencies;
+        //Edges <before, after>
+        std::vector< std::pair<int, int> > edges;
+
+        explicit Dag(int tasks) : dependents(tasks), dependencies(tasks, 0) {}
+
+        //after cannot start before before has completed
+        void add(int before, int after)
+        {
+            this->dependents[before].push_back(after);
+            this->dependencies[after]++;
+            this->edges.push_back(std::make_pair(before, after));
+        }
+    };
+
+    //Same DAG on every run: each task depends on up to three of the previous ones
+    Dag randomDag(int tasks, unsigned seed)
+    {
+        Dag dag(tasks);
+
+        for(int t = 1; t < tasks; t++)
+        {
+            int count = (int)(seed % 4);
+
+            for(int k = 0; k < count; k++)
+            {
+                seed = seed * 1103515245 + 12345;
+                dag.add((int)((seed >> 8) % t), t);
+            }
+
+            seed = seed * 1103515245 + 12345;
+        }
+
+        return dag;
+    }
+
+    /*
+     *  Every task runs once, and only after all the tasks it depends on have completed.
+     */
+    void dependencyOrder(int threads)
+    {
+        const int tasks = 500;
+        Dag dag = randomDag(tasks, 7 + threads);
+
+        std::atomic<int> clock(0);
+        std::unique_ptr< std::atomic<int>[] > runs(new std::atomic<int>[tasks]);
+        std::vector<int> started(tasks, -1), completed(tasks, -1);
+
+        for(int t = 0; t < tasks; t++)
+        {
+            runs[t] = 0;
+        }
+
+        ThreadPool::ThreadPool pool(threads);
+        std::vector<int> skipped = pool.runGraph(dag.dependents, dag.dependencies, [&](int t)
+        {
+            runs[t]++;
+            started[t] = clock++;
+            completed[t] = clock++;
+        });
+
+        std::string where = " (" + std::to_string(threads) + " threads)";
+        check(skipped.empty(), "no task of a DAG is skipped" + where);
+
+        for(int t = 0; t < tasks; t++)
+        {
+            check(runs[t] == 1, "task " + std::to_string(t) + " runs once" + where);
+        }
+
+        for(auto &edge : dag.edges)
+        {
+            check(completed[edge.first] < started[edge.second],
+                  "task " + std::to_string(edge.second) + " starts after task " + std::to_string(edge.first) + " completes" + where);
+        }
+    }
+
+    /*
+     *  Tasks on a cycle, and the ones depending on them, are returned and not run; the others still are.
+     */
+    void cycles(int threads)
+    {
+        //0 -> 1 -> 2 -> 1, 2 -> 3, 4 independent
+        Dag dag(5);
+        dag.add(0, 1);
+        dag.add(1, 2);
+        dag.add(2, 1);
+        dag.add(2, 3);
+
+        std::unique_ptr< std::atomic<int>[] > runs(new std::atomic<int>[5]);
+        for(int t = 0; t < 5; t++)
+        {
+            runs[t] = 0;
+        }
+
+        ThreadPool::ThreadPool pool(threads);
+        std::vector<int> skipped = pool.runGraph(dag.dependents, dag.dependencies, [&](int t) { runs[t]++; });
+
+        std::string where = " (" + std::to_string(threads) + " threads)";
+        check(skipped == std::vector<int>({ 1, 2, 3 }), "tasks 1, 2 and 3 are reported as unreachable" + where);
+        check(runs[0] == 1 && runs[4] == 1, "tasks off the cycle run" + where);
+        check(runs[1] == 0 && runs[2] == 0 && runs[3] == 0, "tasks on or behind the cycle do not run" + where);
+    }
+
+    /*
+     *  A throwing task stops the run: nothing that depends on it runs, and its exception reaches the caller.
+     */
+    void failingTask(int threads)
+    {
+        const int tasks = 200;
+        const int failing = 10;
+        Dag dag = randomDag(tasks, 3);
+
+        //Everything after the failing task depends on it, directly or not
+        for(int t = failing + 1; t < tasks; t++)
+        {
+            dag.add(t - 1, t);
+        }
+
+        std::unique_ptr< std::atomic<int>[] > runs(new std::atomic<int>[tasks]);
+        for(int t = 0; t < tasks; t++)
+        {
+            runs[t] = 0;
+        }
+
+        ThreadPool::ThreadPool pool(threads);
+        std::string message;
+
+        try
+        {
+            pool.runGraph(dag.dependents, dag.dependencies, [&](int t)
+            {
+                runs[t]++;
+
+                if(t == failing)
+                {
+                    throw std::runtime_error("task failed");
+                }
+            });
+        }
+        catch(const std::runtime_error &e)
+        {
+            message = e.what();
+        }
+
+        std::string where = " (" + std::to_string(threads) + " threads)";
+        check(message == "task failed", "the exception of the task is rethrown" + where);
+        check(runs[failing] == 1, "the failing task ran once" + where);
+
+        for(int t = failing + 1; t < tasks; t++)
+        {
+            check(runs[t] == 0, "task " + std::to_string(t) + ", behind the failing one, does not run" + where);
+        }
+
+        //The pool is still usable afterwards
+        std::atomic<int> count(0);
+        pool.runAll(50, [&](int) { count++; });
+        check(count == 50, "runAll after a failure runs every task" + where);
+    }
+}
+
+int main()
+{
+    for(int threads : { 1, 2, 8 })
+    {
+        dependencyOrder(threads);
+        cycles(threads);
+        failingTask(threads);
+    }
+
+    std::printf("thread_pool_test: %s\n", failures == 0 ? "all checks passed" : (std::to_string(failures) + " checks failed").c_str());
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,300 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Standard libraries
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+//Application libraries
+#include "thread_pool.h"
+
+std::mutex &ThreadPool::kernelMutex()
+{
+    static std::mutex kernel;
+
+    return kernel;
+}
+
+ThreadPool::ThreadPool::ThreadPool(int threads)
+{
+    if(threads <= 0)
+    {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+
+    this->threads = threads > 0 ? threads : 1;
+}
+
+int ThreadPool::ThreadPool::getThreads() { return this->threads; }
+
+std::vector<int> ThreadPool::ThreadPool::runGraph(const std::vector< std::vector<int> > &dependents, const std::vector<int> &dependencies, const std::function<void(int)> &task)
+{
+    int total = (int)dependencies.size();
+    std::vector<int> ready;
+    std::vector<int> order;
+    std::vector<int> unreachable;
+
+    //Kahn's count first: tasks on (or behind) a cycle would keep the workers waiting forever, so they are left out of the run
+    {
+        std::vector<int> pending(dependencies);
+
+        for(int i = 0; i < total; i++)
+        {
+            if(pending[i] == 0)
+            {
+                order.push_back(i);
+            }
+        }
+
+        ready = order;
+
+        for(size_t k = 0; k < order.size(); k++)
+        {
+            for(int d : dependents[order[k]])
+            {
+                if(--pending[d] == 0)
+                {
+                    order.push_back(d);
+                }
+            }
+        }
+
+        for(int i = 0; i < total; i++)
+        {
+            if(pending[i] > 0)
+            {
+                unreachable.push_back(i);
+            }
+        }
+    }
+
+    int scheduled = total - (int)unreachable.size();
+
+    if(scheduled == 0)
+    {
+        return unreachable;
+    }
+
+    int workers = std::min(this->threads, scheduled);
+
+    //A single worker runs the topological order on the calling thread: tasks without dependencies keep the index order
+    if(workers == 1)
+    {
+        //An exception ends the run here, none of the tasks after it is started
+        for(int t : order)
+        {
+            task(t);
+        }
+
+        return unreachable;
+    }
+
+    std::vector< std::deque<int> > queues(workers);
+    std::vector<std::mutex> queueLocks(workers);
+    std::unique_ptr< std::atomic<int>[] > pending(new std::atomic<int>[total]);
+    std::atomic<int> remaining(scheduled);
+    std::atomic<int> queued(0);
+    std::mutex idleLock;
+    std::condition_variable idle;
+    std::exception_ptr failure;
+    std::mutex failureLock;
+    //Set by the first failure: from then on no task is started, and the ones still running release nothing
+    std::atomic<bool> cancelled(false);
+
+    for(int i = 0; i < total; i++)
+    {
+        pending[i] = dependencies[i];
+    }
+
+    auto push = [&](int worker, int t)
+    {
+        {
+            std::lock_guard<std::mutex> guard(queueLocks[worker]);
+
+            if(cancelled.load())
+            {
+                return;
+            }
+
+            queues[worker].push_back(t);
+        }
+
+        queued++;
+
+        //Taking the lock orders the increment before the check of a worker that is about to sleep
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+        }
+
+        idle.notify_one();
+    };
+
+    auto take = [&](int worker, int &t) -> bool
+    {
+        {
+            std::lock_guard<std::mutex> guard(queueLocks[worker]);
+
+            if(cancelled.load())
+            {
+                return false;
+            }
+
+            if(!queues[worker].empty())
+            {
+                t = queues[worker].back();
+                queues[worker].pop_back();
+                return true;
+            }
+        }
+
+        for(int k = 1; k < workers; k++)
+        {
+            int victim = (worker + k) % workers;
+            std::lock_guard<std::mutex> guard(queueLocks[victim]);
+
+            if(!cancelled.load() && !queues[victim].empty())
+            {
+                t = queues[victim].front();
+                queues[victim].pop_front();
+                return true;
+            }
+        }
+
+        return false;
+    };
+
+    //Drops the queued tasks and wakes up the idle workers, so that they return
+    auto cancel = [&]()
+    {
+        cancelled = true;
+
+        for(int w = 0; w < workers; w++)
+        {
+            std::lock_guard<std::mutex> guard(queueLocks[w]);
+            queued -= (int)queues[w].size();
+            queues[w].clear();
+        }
+
+        std::lock_guard<std::mutex> guard(idleLock);
+        idle.notify_all();
+    };
+
+    auto work = [&](int worker)
+    {
+        while(!cancelled.load())
+        {
+            int t = -1;
+
+            if(take(worker, t))
+            {
+                queued--;
+
+                try
+                {
+                    task(t);
+                }
+                catch(...)
+                {
+                    {
+                        std::lock_guard<std::mutex> guard(failureLock);
+
+                        if(!failure)
+                        {
+                            failure = std::current_exception();
+                        }
+                    }
+
+                    cancel();
+                }
+
+                //The dependents of a failed task would run without its results
+                if(cancelled.load())
+                {
+                    return;
+                }
+
+                //Unlocked tasks stay on this worker, they are likely to share data with the one just completed
+                for(int d : dependents[t])
+                {
+                    if(--pending[d] == 0)
+                    {
+                        push(worker, d);
+                    }
+                }
+
+                if(--remaining == 0)
+                {
+                    std::lock_guard<std::mutex> guard(idleLock);
+                    idle.notify_all();
+                }
+
+                continue;
+            }
+
+            std::unique_lock<std::mutex> guard(idleLock);
+            idle.wait(guard, [&]{ return queued.load() > 0 || remaining.load() == 0 || cancelled.load(); });
+
+            if(remaining.load() == 0)
+            {
+                return;
+            }
+        }
+    };
+
+    //Tasks without dependencies are dealt round robin, in index order
+    for(size_t k = 0; k < ready.size(); k++)
+    {
+        push((int)k % workers, ready[k]);
+    }
+
+    std::vector<std::thread> pool;
+
+    for(int w = 1; w < workers; w++)
+    {
+        pool.push_back(std::thread(work, w));
+    }
+
+    work(0);
+
+    for(auto &thread : pool)
+    {
+        thread.join();
+    }
+
+    if(failure)
+    {
+        std::rethrow_exception(failure);
+    }
+
+    return unreachable;
+}
+
+void ThreadPool::ThreadPool::runAll(int tasks, const std::function<void(int)> &task)
+{
+    std::vector< std::vector<int> > dependents(tasks);
+    std::vector<int> dependencies(tasks, 0);
+
+    this->runGraph(dependents, dependencies, task);
+}
@@ -0,0 +1,70 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+//Standard libraries
+#include <vector>
+#include <functional>
+#include <mutex>
+
+namespace ThreadPool
+{
+    /*
+     *  Lock around the Yosys kernel. IdString reference counts and interning, the hashlib tables (which rehash inside lookups) and the log
+     *  are process-wide and unsynchronized: a pool task must hold this lock while it reads RTLIL objects or logs.
+     */
+    std::mutex &kernelMutex();
+
+    /*
+     *  Work-stealing pool used for running the per-module phases of the analysis. Every worker owns a deque: it pushes and pops its own
+     *  tasks at the back and, when it runs dry, steals from the front of the others. Workers live for the duration of a single run.
+     */
+    class ThreadPool
+    {
+        private:
+            //Number of workers, the calling thread included
+            int threads;
+
+        public:
+            /*
+             *  threads <= 0 uses one worker per hardware thread. With a single worker everything runs on the calling thread.
+             */
+            ThreadPool(int threads = 0);
+
+            int getThreads();
+
+            /*
+             *  Runs task(i) once for each task of a DAG. dependencies[i] is the number of tasks that must complete before i can start,
+             *  dependents[i] the tasks waiting for i. A task is dispatched as soon as its last dependency completes.
+             *  Returns the tasks that could never start because of cyclic dependencies (empty for a DAG); they are not run.
+             *  If a task throws, no other task is started: the queued ones are dropped, the dependents of the failed task (and of the ones
+             *  still running) are never released, and the first exception is rethrown once the running tasks have returned.
+             */
+            std::vector<int> runGraph(const std::vector< std::vector<int> > &dependents, const std::vector<int> &dependencies, const std::function<void(int)> &task);
+
+            /*
+             *  Runs task(i) for i in [0, tasks), with no ordering constraints.
+             */
+            void runAll(int tasks, const std::function<void(int)> &task);
+    };
+}
+
+#endif
@@ -0,0 +1,166 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+//Standard libraries
+#include <algorithm>
+#include <fstream>
+
+//Application libraries
+#include "trace.h"
+#include "stdstring_support.h"
+
+namespace
+{
+    std::atomic<Trace::Recorder *> activeRecorder(nullptr);
+    std::atomic<unsigned> nextSerial(1);
+
+    //Buffer of the calling thread and the recorder it belongs to
+    thread_local unsigned bufferSerial = 0;
+    thread_local Trace::ThreadBuffer *buffer = nullptr;
+}
+
+Trace::Recorder::Recorder(size_t capacity)
+{
+    this->capacity = capacity > 0 ? capacity : 1;
+    this->origin = std::chrono::steady_clock::now();
+    this->serial = nextSerial++;
+}
+
+Trace::Recorder::~Recorder()
+{
+    this->stop();
+}
+
+void Trace::Recorder::start()
+{
+    activeRecorder.store(this);
+}
+
+void Trace::Recorder::stop()
+{
+    Recorder *self = this;
+    activeRecorder.compare_exchange_strong(self, nullptr);
+}
+
+Trace::Recorder *Trace::Recorder::active()
+{
+    return activeRecorder.load(std::memory_order_relaxed);
+}
+
+Trace::ThreadBuffer *Trace::Recorder::threadBuffer()
+{
+    if(bufferSerial != this->serial)
+    {
+        std::lock_guard<std::mutex> guard(this->buffersLock);
+
+        this->buffers.emplace_back(new ThreadBuffer());
+        buffer = this->buffers.back().get();
+        buffer->threadId = (int)this->buffers.size();
+        buffer->events.resize(this->capacity);
+        bufferSerial = this->serial;
+    }
+
+    return buffer;
+}
+
+void Trace::Recorder::record(const char *phase, const std::string *module, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end)
+{
+    ThreadBuffer *ring = this->threadBuffer();
+    Event &event = ring->events[ring->written % this->capacity];
+
+    event.phase = phase;
+    event.module = module;
+    event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(begin - this->origin).count();
+    event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+
+    ring->written++;
+}
+
+uint64_t Trace::Recorder::dropped() const
+{
+    uint64_t lost = 0;
+
+    for(auto &ring : this->buffers)
+    {
+        lost += ring->written > this->capacity ? ring->written - this->capacity : 0;
+    }
+
+    return lost;
+}
+
+bool Trace::Recorder::writeChromeTrace(const std::string &filepath) const
+{
+    std::ofstream trace(filepath, std::ios::out | std::ios::trunc);
+
+    if(!trace.is_open())
+    {
+        return false;
+    }
+
+    //Timestamps are in microseconds
+    trace.setf(std::ios::fixed);
+    trace.precision(3);
+
+    trace << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    trace << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": 0, \"args\": {\"name\": \"sans\"}}";
+
+    for(auto &ring : this->buffers)
+    {
+        trace << ",\n  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << ring->threadId
+              << ", \"args\": {\"name\": \"worker " << ring->threadId << "\"}}";
+
+        //Oldest event first: after a wrap around it is the one at the write position
+        uint64_t kept = std::min<uint64_t>(ring->written, this->capacity);
+        uint64_t first = ring->written - kept;
+
+        for(uint64_t k = first; k < ring->written; k++)
+        {
+            const Event &event = ring->events[k % this->capacity];
+            std::string module = event.module != nullptr ? StringSupport::jsonEscape(*event.module) : "";
+
+            trace << ",\n  {\"name\": \"" << event.phase << " " << module << "\", \"cat\": \"" << event.phase << "\", \"ph\": \"X\", \"ts\": "
+                  << event.start * 1e-3 << ", \"dur\": " << event.duration * 1e-3 << ", \"pid\": 1, \"tid\": " << ring->threadId
+                  << ", \"args\": {\"module\": \"" << module << "\"}}";
+        }
+    }
+
+    trace << "\n]}\n";
+
+    return (bool)trace;
+}
+
+Trace::Span::Span(const char *phase, const std::string *module)
+{
+    this->recorder = Recorder::active();
+    this->phase = phase;
+    this->module = module;
+
+    if(this->recorder != nullptr)
+    {
+        this->begin = std::chrono::steady_clock::now();
+    }
+}
+
+Trace::Span::~Span()
+{
+    if(this->recorder != nullptr)
+    {
+        this->recorder->record(this->phase, this->module, this->begin, std::chrono::steady_clock::now());
+    }
+}
@@ -0,0 +1,124 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+//Standard libraries
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Trace
+{
+    /*
+     *  One span of the timeline. phase is a string literal and module points to a name owned by the caller (the DesignAnalyzer), so that
+     *  recording copies no strings: both must outlive the export.
+     */
+    struct Event
+    {
+        const char *phase;
+        const std::string *module;
+        //Nanoseconds since the start of the recorder
+        int64_t start;
+        int64_t duration;
+    };
+
+    /*
+     *  Events of one thread. Only that thread writes it, as a ring: when it is full the oldest events are overwritten.
+     */
+    struct ThreadBuffer
+    {
+        int threadId;
+        std::vector<Event> events;
+        uint64_t written = 0;
+    };
+
+    /*
+     *  Timeline of a run, exported as a Chrome trace (the JSON read by chrome://tracing and Perfetto). Recording takes no lock: each thread
+     *  fills its own ring buffer, registered the first time it records. Export once the workers are done.
+     */
+    class Recorder
+    {
+        private:
+            size_t capacity;
+            std::chrono::steady_clock::time_point origin;
+            //Tells apart the buffers of this recorder from the ones the threads kept from an earlier one
+            unsigned serial;
+
+            std::mutex buffersLock;
+            std::vector< std::unique_ptr<ThreadBuffer> > buffers;
+
+            ThreadBuffer *threadBuffer();
+
+        public:
+            //Events kept per thread
+            static const size_t DEFAULT_CAPACITY = 1 << 16;
+
+            Recorder(size_t capacity = DEFAULT_CAPACITY);
+            ~Recorder();
+
+            Recorder(const Recorder &) = delete;
+            Recorder &operator=(const Recorder &) = delete;
+
+            /*
+             *  Spans are recorded by the active recorder only, if there is one. start() makes this one active, stop() turns recording off.
+             */
+            void start();
+            void stop();
+            static Recorder *active();
+
+            void record(const char *phase, const std::string *module, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+
+            /*
+             *  Events overwritten because a ring was full.
+             */
+            uint64_t dropped() const;
+
+            /*
+             *  Writes the events as "complete" (ph X) events, plus the names of the threads. Returns false if the file cannot be written.
+             */
+            bool writeChromeTrace(const std::string &filepath) const;
+    };
+
+    /*
+     *  Records the time until the end of the scope on the active recorder. Without one it only reads an atomic pointer.
+     */
+    class Span
+    {
+        private:
+            Recorder *recorder;
+            const char *phase;
+            const std::string *module;
+            std::chrono::steady_clock::time_point begin;
+
+        public:
+            Span(const char *phase, const std::string *module);
+            ~Span();
+
+            Span(const Span &) = delete;
+            Span &operator=(const Span &) = delete;
+    };
+}
+
+#endif
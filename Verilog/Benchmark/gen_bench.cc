@@ -0,0 +1,339 @@
+/*
+ *
+ *  Copyright (C) 2019  Cugini Lorenzo <lorenzo.cugini@mail.polimi.it>
+ *                      Lagni Luca <luca.lagni@mail.polimi.it>
+ *
+ *  Permission to use, copy, modify, and/or distribute this software for any
+ *  purpose with or without fee is hereby granted, provided that the above
+ *  copyright notice and this permission notice appear in all copies.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ *  WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ *  MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ *  ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ *  WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ *  ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ *  OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ */
+
+/*
+ *  Synthetic benchmark designs for SANS. Writes to stdout a Verilog design of about the requested number of cells (as counted after
+ *  read_verilog; proc), made of one of the structures that stress the analysis:
+ *
+ *      muxtree     wide trees of 2:1 muxes, every level selected by a different bit
+ *      pipeline    deep chains of registers with a little logic between the stages
+ *      slices      a wide bus read through overlapping partial slices, the same bits both as data and as selection
+ *      feedback    registers looping back on themselves through adders and muxes, chained in one long loop
+ *      hierarchy   a chain of nested modules, each level with a body of the kinds above and the next level inside
+ *      mixed       the four flat kinds in turn
+ *
+ *  Flat kinds are split in modules of at most -m cells, chained by a top module: SANS analyzes each module once, so every block is a
+ *  different module.
+ *
+ *  Build:  g++ -O2 -std=c++11 -o gen_bench gen_bench.cc
+ *  Usage:  gen_bench <kind> <cells> [-m module_cells] [-w width] [-s seed] > design.v
+ */
+
+//Standard libraries
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    enum Kind { MUXTREE, PIPELINE, SLICES, FEEDBACK, HIERARCHY, MIXED };
+
+    const char *kindNames[] = { "muxtree", "pipeline", "slices", "feedback", "hierarchy", "mixed" };
+
+    //Bits of sel, the selection input of every module
+    const int SEL_BITS = 8;
+
+    struct Options
+    {
+        Kind kind = MUXTREE;
+        long long cells = 1000;
+        long long moduleCells = 10000;
+        int width = 16;
+        uint64_t seed = 1;
+    };
+
+    //xorshift64*: same design for the same seed on every platform
+    uint64_t rngState = 1;
+
+    uint64_t nextRandom()
+    {
+        rngState ^= rngState >> 12;
+        rngState ^= rngState << 25;
+        rngState ^= rngState >> 27;
+        return rngState * 2685821657736338717ULL;
+    }
+
+    int randomBelow(int n)
+    {
+        return (int)(nextRandom() % (uint64_t)n);
+    }
+
+    /*
+     *  Bodies write the statements of a module whose ports are clk, a, b ([width-1:0]) and sel ([SEL_BITS-1:0]) and return the name of a
+     *  [width-1:0] wire holding their result. They use about cells cells.
+     */
+
+    std::string muxtreeBody(FILE *out, long long cells, int width)
+    {
+        //Leaves read the inputs whole or as two swapped halves
+        int half = width / 2;
+        std::string leaves[4] = {
+            "a", "b",
+            "{b[" + std::to_string(half - 1) + ":0], a[" + std::to_string(width - 1) + ":" + std::to_string(half) + "]}",
+            "{a[" + std::to_string(half - 1) + ":0], b[" + std::to_string(width - 1) + ":" + std::to_string(half) + "]}"
+        };
+
+        std::string result = "a";
+        long long used = 0;
+
+        for(int tree = 0; used < cells; tree++)
+        {
+            //Up to 1024 leaves per tree: 1023 muxes, plus the xor that merges it into the result
+            long long leafCount = 2;
+            while(leafCount < 1024 && leafCount < cells - used)
+            {
+                leafCount *= 2;
+            }
+
+            //Heap numbering: node i has children 2i and 2i+1, ids from leafCount up are leaves
+            for(long long node = leafCount - 1; node >= 1; node--)
+            {
+                int depth = 63 - __builtin_clzll((unsigned long long)node);
+                std::string child[2];
+
+                for(int c = 0; c < 2; c++)
+                {
+                    long long id = 2 * node + c;
+                    child[c] = id >= leafCount ? leaves[(id + tree) % 4] : "t" + std::to_string(tree) + "_" + std::to_string(id);
+                }
+
+                fprintf(out, "  wire [%d:0] t%d_%lld = sel[%d] ? %s : %s;\n", width - 1, tree, node, (tree + depth) % SEL_BITS, child[0].c_str(), child[1].c_str());
+            }
+
+            fprintf(out, "  wire [%d:0] tx%d = %s ^ t%d_1;\n", width - 1, tree, result.c_str(), tree);
+            result = "tx" + std::to_string(tree);
+            used += leafCount;
+        }
+
+        return result;
+    }
+
+    std::string pipelineBody(FILE *out, long long cells, int width)
+    {
+        //Two cells per stage: the xor with one of the inputs and the register
+        std::string previous = "a";
+
+        for(long long stage = 0; 2 * stage < cells; stage++)
+        {
+            fprintf(out, "  reg [%d:0] p%lld;\n", width - 1, stage);
+            fprintf(out, "  always @(posedge clk) p%lld <= %s ^ %s;\n", stage, previous.c_str(), stage % 2 ? "a" : "b");
+            previous = "p" + std::to_string(stage);
+        }
+
+        return previous;
+    }
+
+    std::string slicesBody(FILE *out, long long cells, int width)
+    {
+        //Two cells per step: the xor of two overlapping slices of the bus, then a mux selected by a single bit of the same bus
+        fprintf(out, "  wire [%d:0] bus = {a, b};\n", 2 * width - 1);
+
+        std::string previous = "a";
+
+        for(long long step = 0; 2 * step < cells; step++)
+        {
+            int first = randomBelow(width + 1);
+            int second = randomBelow(width);
+            second += second >= first;
+            int selector = randomBelow(2 * width);
+
+            fprintf(out, "  wire [%d:0] s%lld = bus[%d:%d] ^ bus[%d:%d];\n", width - 1, step, first + width - 1, first, second + width - 1, second);
+            fprintf(out, "  wire [%d:0] u%lld = bus[%d] ? s%lld : %s;\n", width - 1, step, selector, step, previous.c_str());
+            previous = "u" + std::to_string(step);
+        }
+
+        return previous;
+    }
+
+    std::string feedbackBody(FILE *out, long long cells, int width)
+    {
+        //Four cells per group: the register loops on itself through the adder or the xor, and reads the previous group
+        long long groups = cells / 4 > 0 ? cells / 4 : 1;
+
+        for(long long group = 0; group < groups; group++)
+        {
+            fprintf(out, "  reg [%d:0] r%lld;\n", width - 1, group);
+        }
+
+        for(long long group = 0; group < groups; group++)
+        {
+            //The first group closes the long loop through the last one
+            std::string input = group == 0 ? "(a ^ r" + std::to_string(groups - 1) + ")" : "r" + std::to_string(group - 1);
+
+            fprintf(out, "  wire [%d:0] f%lld = r%lld + b;\n", width - 1, group, group);
+            fprintf(out, "  wire [%d:0] g%lld = sel[%lld] ? f%lld : (r%lld ^ %s);\n", width - 1, group, group % SEL_BITS, group, group, input.c_str());
+            fprintf(out, "  always @(posedge clk) r%lld <= g%lld;\n", group, group);
+        }
+
+        return "r" + std::to_string(groups - 1);
+    }
+
+    std::string body(FILE *out, Kind kind, long long cells, int width)
+    {
+        switch(kind)
+        {
+            case MUXTREE:
+                return muxtreeBody(out, cells, width);
+            case PIPELINE:
+                return pipelineBody(out, cells, width);
+            case SLICES:
+                return slicesBody(out, cells, width);
+            default:
+                return feedbackBody(out, cells, width);
+        }
+    }
+
+    void moduleHeader(FILE *out, const std::string &name, int width)
+    {
+        fprintf(out, "\nmodule %s (\n  input clk,\n  input [%d:0] a,\n  input [%d:0] b,\n  input [%d:0] sel,\n  output [%d:0] y\n);\n",
+                name.c_str(), width - 1, width - 1, SEL_BITS - 1, width - 1);
+    }
+
+    //Flat kinds: blocks of at most moduleCells cells, the output of each one is the a of the next
+    void flatDesign(FILE *out, const Options &options)
+    {
+        long long blocks = (options.cells + options.moduleCells - 1) / options.moduleCells;
+
+        for(long long block = 0; block < blocks; block++)
+        {
+            Kind kind = options.kind == MIXED ? (Kind)(block % 4) : options.kind;
+            long long cells = block + 1 < blocks ? options.moduleCells : options.cells - block * options.moduleCells;
+
+            moduleHeader(out, std::string(kindNames[kind]) + "_" + std::to_string(block), options.width);
+            fprintf(out, "  assign y = %s;\nendmodule\n", body(out, kind, cells, options.width).c_str());
+        }
+
+        moduleHeader(out, "top", options.width);
+        std::string previous = "a";
+
+        for(long long block = 0; block < blocks; block++)
+        {
+            Kind kind = options.kind == MIXED ? (Kind)(block % 4) : options.kind;
+
+            fprintf(out, "  wire [%d:0] y%lld;\n", options.width - 1, block);
+            fprintf(out, "  %s_%lld u%lld (.clk(clk), .a(%s), .b(b), .sel(sel), .y(y%lld));\n", kindNames[kind], block, block, previous.c_str(), block);
+            previous = "y" + std::to_string(block);
+        }
+
+        fprintf(out, "  assign y = %s;\nendmodule\n", previous.c_str());
+    }
+
+    //Hierarchy: level k holds a body and level k+1, the deepest level is only a body; the top is level 0
+    void hierarchyDesign(FILE *out, const Options &options)
+    {
+        long long levels = (options.cells + options.moduleCells - 1) / options.moduleCells;
+        if(levels < 2)
+        {
+            levels = 2;
+        }
+
+        long long cells = options.cells / levels > 0 ? options.cells / levels : 1;
+
+        //Innermost first, so that every module is declared before it is used
+        for(long long level = levels - 1; level >= 0; level--)
+        {
+            moduleHeader(out, level == 0 ? "top" : "level_" + std::to_string(level), options.width);
+            std::string result = body(out, (Kind)(level % 4), cells, options.width);
+
+            if(level + 1 < levels)
+            {
+                fprintf(out, "  wire [%d:0] inner;\n", options.width - 1);
+                fprintf(out, "  level_%lld next (.clk(clk), .a(%s), .b(b), .sel(sel), .y(inner));\n", level + 1, result.c_str());
+                result = "inner";
+            }
+
+            fprintf(out, "  assign y = %s;\nendmodule\n", result.c_str());
+        }
+    }
+
+    void usage()
+    {
+        fprintf(stderr, "Usage: gen_bench <muxtree|pipeline|slices|feedback|hierarchy|mixed> <cells> [-m module_cells] [-w width] [-s seed]\n");
+        exit(1);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+
+    if(argc < 3)
+    {
+        usage();
+    }
+
+    bool known = false;
+    for(int k = 0; k <= MIXED; k++)
+    {
+        if(strcmp(argv[1], kindNames[k]) == 0)
+        {
+            options.kind = (Kind)k;
+            known = true;
+        }
+    }
+
+    options.cells = atoll(argv[2]);
+
+    for(int argidx = 3; argidx + 1 < argc; argidx += 2)
+    {
+        if(strcmp(argv[argidx], "-m") == 0)
+        {
+            options.moduleCells = atoll(argv[argidx + 1]);
+        }
+        else if(strcmp(argv[argidx], "-w") == 0)
+        {
+            options.width = atoi(argv[argidx + 1]);
+        }
+        else if(strcmp(argv[argidx], "-s") == 0)
+        {
+            options.seed = strtoull(argv[argidx + 1], nullptr, 10);
+        }
+        else
+        {
+            usage();
+        }
+    }
+
+    if(!known || options.cells <= 0 || options.moduleCells <= 0 || options.width < 2 || (argc - 3) % 2 != 0)
+    {
+        usage();
+    }
+
+    rngState = options.seed != 0 ? options.seed : 1;
+
+    //A large stdio buffer: the big designs are hundreds of megabytes
+    static char buffer[1 << 20];
+    setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
+
+    printf("// SANS benchmark: %s, about %lld cells, width %d, seed %llu\n", kindNames[options.kind], options.cells, options.width, (unsigned long long)options.seed);
+
+    if(options.kind == HIERARCHY)
+    {
+        hierarchyDesign(stdout, options);
+    }
+    else
+    {
+        flatDesign(stdout, options);
+    }
+
+    return fflush(stdout) == 0 ? 0 : 1;
+}
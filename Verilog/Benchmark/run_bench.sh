@@ -0,0 +1,138 @@
+#!/bin/bash
+
+#
+#  Timing harness for SANS on the synthetic designs of gen_bench.cc.
+#  For every kind and size it generates the design, runs read_verilog, proc and sans -profile in yosys and records the time of each pass,
+#  the phases of the analysis (from the -profile output) and the peak resident memory. The results go in results.tsv of the work
+#  directory; with a baseline they are compared against it and the script fails if anything got slower (or bigger) than the threshold.
+#
+#  Usage: ./run_bench.sh [options]
+#      -p <pass.so>        the SANS plugin (default ../../SANS/pass.so, built with yosys-config when missing)
+#      -k "<kinds>"        muxtree pipeline slices feedback hierarchy mixed (default all of them)
+#      -n "<cells>"        design sizes in cells (default "1000 10000 100000"; gen_bench goes up to tens of millions)
+#      -b <baseline.tsv>   compare against this baseline
+#      -s <baseline.tsv>   save the results as the new baseline
+#      -t <percent>        allowed slowdown before a run counts as a regression (default 25)
+#      -w <dir>            work directory for designs, logs and results (default ./bench_work)
+#      -a "<args>"         extra arguments for sans, e.g. "-threads 1"
+#
+#  Timings depend on the machine: baselines are meant to be recorded and compared on the same host.
+#
+
+HERE="$(cd "$(dirname "$0")" && pwd)"
+PLUGIN="$HERE/../../SANS/pass.so"
+KINDS="muxtree pipeline slices feedback hierarchy mixed"
+SIZES="1000 10000 100000"
+BASELINE=""
+SAVE=""
+THRESHOLD=25
+WORK="$HERE/bench_work"
+SANS_ARGS=""
+
+#Differences below this many seconds (or KB) are noise, whatever the ratio
+NOISE_S=0.05
+NOISE_KB=4096
+
+while getopts "p:k:n:b:s:t:w:a:" option; do
+    case "$option" in
+        p) PLUGIN="$OPTARG" ;;
+        k) KINDS="$OPTARG" ;;
+        n) SIZES="$OPTARG" ;;
+        b) BASELINE="$OPTARG" ;;
+        s) SAVE="$OPTARG" ;;
+        t) THRESHOLD="$OPTARG" ;;
+        w) WORK="$OPTARG" ;;
+        a) SANS_ARGS="$OPTARG" ;;
+        *) sed -n '9,17p' "$0" | sed 's/^#//'; exit 2 ;;
+    esac
+done
+
+command -v yosys > /dev/null || { echo "yosys not found in PATH"; exit 2; }
+
+mkdir -p "$WORK/OUTPUT" || exit 2
+WORK="$(cd "$WORK" && pwd)"
+
+g++ -O2 -std=c++11 -o "$WORK/gen_bench" "$HERE/gen_bench.cc" || exit 2
+
+if [ ! -f "$PLUGIN" ]; then
+    echo "Building $PLUGIN"
+    (cd "$(dirname "$PLUGIN")" && yosys-config --build pass.so *.cc) || exit 2
+fi
+PLUGIN="$(cd "$(dirname "$PLUGIN")" && pwd)/$(basename "$PLUGIN")"
+
+RESULTS="$WORK/results.tsv"
+printf "kind\tcells\twall_s\tread_verilog_s\tproc_s\tsans_s\tmod2graph_ms\tbuildGraph_ms\tcheck_ms\tDFS_FTSA_ms\tdeepScan_ms\toutput_ms\tpeak_rss_kb\n" > "$RESULTS"
+
+FAILED=0
+
+for kind in $KINDS; do
+    for cells in $SIZES; do
+        design="$WORK/${kind}_${cells}.v"
+        log="$WORK/${kind}_${cells}.log"
+
+        "$WORK/gen_bench" "$kind" "$cells" > "$design" || { echo "$kind $cells: generation failed"; FAILED=1; continue; }
+        rm -f "$WORK/OUTPUT/sans_profile.json"
+
+        #-t stamps every log line with the elapsed seconds. Each -p gets its own "Running command" line, marking where the pass starts
+        start=$(date +%s.%N)
+        (cd "$WORK" && yosys -t -m "$PLUGIN" -p "read_verilog $design" -p "proc" -p "sans -nout -profile $SANS_ARGS" > "$log" 2>&1)
+        status=$?
+        end=$(date +%s.%N)
+
+        if [ $status -ne 0 ] || [ ! -f "$WORK/OUTPUT/sans_profile.json" ]; then
+            echo "$kind $cells: yosys failed, see $log"
+            FAILED=1
+            continue
+        fi
+
+        passes=$(awk '
+            match($0, /^\[[0-9.]+\]/) { stamp = substr($0, 2, RLENGTH - 2) + 0 }
+            /-- Running command `read_verilog / { start["read_verilog"] = stamp }
+            /-- Running command `proc. --/ { start["proc"] = stamp }
+            /-- Running command `sans / { start["sans"] = stamp }
+            /End of script/ { finish = stamp }
+            END {
+                if(!("read_verilog" in start) || !("proc" in start) || !("sans" in start) || finish == "") { exit 1 }
+                printf "%.3f\t%.3f\t%.3f", start["proc"] - start["read_verilog"], start["sans"] - start["proc"], finish - start["sans"]
+            }
+        ' "$log") || { echo "$kind $cells: the passes are not all in $log"; FAILED=1; continue; }
+
+        #The profile keeps the totals of every phase on the single "total" line
+        phases=$(grep '"total"' "$WORK/OUTPUT/sans_profile.json" | sed 's/.*"phasesNs": {\([^}]*\)}.*/\1/' \
+                 | awk -F', ' '{ for(i = 1; i <= NF; i++) { split($i, pair, ": "); printf "%s%.3f", (i > 1 ? "\t" : ""), pair[2] / 1e6 } }')
+        rss=$(sed -n 's/.*"peakRssKb": \([0-9]*\).*/\1/p' "$WORK/OUTPUT/sans_profile.json")
+        wall=$(awk -v s="$start" -v e="$end" 'BEGIN { printf "%.3f", e - s }')
+
+        printf "%s\t%s\t%s\t%s\t%s\t%s\n" "$kind" "$cells" "$wall" "$passes" "$phases" "$rss" >> "$RESULTS"
+        printf "%-10s %10s cells  %8s s  %8s KB\n" "$kind" "$cells" "$wall" "$rss"
+    done
+done
+
+if [ -n "$SAVE" ]; then
+    cp "$RESULTS" "$SAVE" && echo "Baseline saved in $SAVE"
+fi
+
+if [ -n "$BASELINE" ]; then
+    #Wall time, the time of sans alone and the peak memory are checked, the other columns are there to see where the time went
+    awk -F'\t' -v threshold="$THRESHOLD" -v noise_s="$NOISE_S" -v noise_kb="$NOISE_KB" '
+        function check(name, old, new, noise) {
+            if(new > old * (1 + threshold / 100) && new - old > noise) {
+                printf "REGRESSION %-10s %10s cells  %-8s %12s -> %12s (%+.1f%%)\n", $1, $2, name, old, new, (old > 0 ? 100 * (new - old) / old : 100)
+                bad++
+            }
+        }
+        FNR == 1 { next }
+        NR == FNR { base[$1 "\t" $2] = $0; next }
+        !(($1 "\t" $2) in base) { printf "%-10s %10s cells  not in the baseline\n", $1, $2; next }
+        {
+            split(base[$1 "\t" $2], old, "\t")
+            printf "%-10s %10s cells  wall %8s -> %8s s  sans %8s -> %8s s  rss %10s -> %10s KB\n", $1, $2, old[3], $3, old[6], $6, old[13], $13
+            check("wall_s", old[3], $3, noise_s)
+            check("sans_s", old[6], $6, noise_s)
+            check("rss_kb", old[13], $13, noise_kb)
+        }
+        END { exit bad > 0 }
+    ' "$BASELINE" "$RESULTS" || FAILED=1
+fi
+
+exit $FAILED